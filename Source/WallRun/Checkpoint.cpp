@@ -7,17 +7,26 @@
 #include "Components/AudioComponent.h"
 #include "Components/SphereComponent.h"
 #include "Components/PointLightComponent.h"
-#include "TimerManager.h"
 #include "Components/ArrowComponent.h"
+#include "WallRunTaskScheduler.h"
+#include "WallRunMemory.h"
+#include "WallRunTelemetry.h"
+#include "Net/UnrealNetwork.h"
 
 
 
 // Sets default values
 ACheckpoint::ACheckpoint()
 {
+	LLM_SCOPE_BYTAG(WallRunCheckpoint);
+
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = false;
 
+	// nothing to send until the checkpoint is activated
+	bReplicates = true;
+	NetDormancy = DORM_Initial;
+
 	// init components
 
 	TriggerMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Trigger visualiser"));
@@ -38,14 +47,50 @@ ACheckpoint::ACheckpoint()
 	AudioSaving->SetAutoActivate(false);
 }
 
+void ACheckpoint::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ACheckpoint, bActivated);
+}
+
 // Called when the game starts or when spawned
 void ACheckpoint::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(WallRunCheckpoint);
+
 	Super::BeginPlay();
 
 	NewStartPoint = GetActorLocation();
 }
 
+void ACheckpoint::PreRegisterAllComponents()
+{
+	// render and physics state of mesh, light and audio is created on register.
+	// Checkpoints are placed in the level, so they are registered by level load and
+	// streaming, there is no WallRun spawn site to put a scope around. AActor has no
+	// virtual around the registration itself, this is the last one called before it.
+	// Components registered here are skipped by RegisterAllComponents and
+	// IncrementalRegisterComponents, so all of the registration gets the tag.
+	LLM_SCOPE_BYTAG(WallRunCheckpoint);
+
+	Super::PreRegisterAllComponents();
+
+	// parents before children
+	if (RootComponent != nullptr && RootComponent->bAutoRegister && !RootComponent->IsRegistered())
+	{
+		RootComponent->RegisterComponent();
+	}
+
+	for (UActorComponent* Component : GetComponents())
+	{
+		if (Component != nullptr && Component->bAutoRegister && !Component->IsRegistered())
+		{
+			Component->RegisterComponent();
+		}
+	}
+}
+
 bool ACheckpoint::Seving(AWallRunCharacter* player)
 {
 	if (IsValid(player))
@@ -53,6 +98,14 @@ bool ACheckpoint::Seving(AWallRunCharacter* player)
 		NewStartPoint.Z = player->GetActorLocation().Z;
 
 		player->SaveCheckpoint(NewStartPoint, GetActorRotation(), NewDeadlyHeight);
+		player->StartGhostRun(GetName());
+
+		// start point saved on spawn is not an activation, so the event is recorded here,
+		// for the player's own character only
+		if (player->IsLocallyControlled())
+		{
+			FWallRunTelemetry::Record(EWallRunTelemetryEvent::Checkpoint, player, GetWorld()->GetTimeSeconds());
+		}
 
 		return true;
 	}
@@ -68,14 +121,70 @@ void ACheckpoint::OnTriggerOverlapBegin(UPrimitiveComponent* OverlappedComp, AAc
 	{
 		if (Seving(Player))
 		{
-			if (AudioSaving)
+			HitCollider->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+			if (HasAuthority())
 			{
-				AudioSaving->Play();
+				// wake up once so clients and replays get the activation
+				bActivated = true;
+				FlushNetDormancy();
+
+				if (UWallRunTimingWheel* TimingWheel = UWallRunTimingWheel::Get(this))
+				{
+					TimingWheel->SetTimer(DestroyTimer, this, &ACheckpoint::SaveCompletes, TimeToDie);
+				}
+				else
+				{
+					SaveComplete();
+				}
 			}
-			TriggerMesh->SetHiddenInGame(true);
-			HitCollider->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-			ActiveLight->SetHiddenInGame(true);
-			GetWorld()->GetTimerManager().SetTimer(DestroyTimer, this, &ACheckpoint::SaveComplete, TimeToDie, false);
+
+			ScheduleActivateEffects();
 		}
 	}
-}
\ No newline at end of file
+}
+
+void ACheckpoint::OnRep_Activated()
+{
+	if (bActivated)
+	{
+		HitCollider->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		ScheduleActivateEffects();
+	}
+}
+
+void ACheckpoint::ScheduleActivateEffects()
+{
+	if (bEffectsScheduled)
+	{
+		return;
+	}
+	bEffectsScheduled = true;
+
+	// cosmetic part can wait for a frame with free time
+	UWallRunTaskScheduler::AddTask(this, EWallRunTaskPriority::Normal, [WeakThis = TWeakObjectPtr<ACheckpoint>(this)]()
+	{
+		if (ACheckpoint* Checkpoint = WeakThis.Get())
+		{
+			Checkpoint->PlayActivateEffects();
+		}
+	});
+}
+
+void ACheckpoint::PlayActivateEffects()
+{
+	if (AudioSaving)
+	{
+		AudioSaving->Play();
+	}
+	TriggerMesh->SetHiddenInGame(true);
+	ActiveLight->SetHiddenInGame(true);
+}
+
+void ACheckpoint::SaveCompletes(TArrayView<UObject* const> Checkpoints)
+{
+	for (UObject* Checkpoint : Checkpoints)
+	{
+		CastChecked<ACheckpoint>(Checkpoint)->SaveComplete();
+	}
+}
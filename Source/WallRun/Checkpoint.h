@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "WallRunTimingWheel.h"
 #include "Checkpoint.generated.h"
 
 
@@ -43,9 +44,13 @@ public:
 	// Sets default values for this actor's properties
 	ACheckpoint();
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	// registers components under the checkpoint memory tag
+	virtual void PreRegisterAllComponents() override;
 
 	UFUNCTION()
 	bool Seving(AWallRunCharacter* player);
@@ -56,8 +61,23 @@ protected:
 			bool bFromSweep, const	FHitResult& SweepResult);
 
 	void SaveComplete() { Destroy(); };
+	static void SaveCompletes(TArrayView<UObject* const> Checkpoints);
+
+	// sound and hiding after activation
+	void PlayActivateEffects();
+	// once per checkpoint, on the frame the scheduler has time
+	void ScheduleActivateEffects();
+
+	// the only replicated state, sent once when dormancy is flushed on activation
+	UPROPERTY(ReplicatedUsing = OnRep_Activated)
+	bool bActivated = false;
+
+	UFUNCTION()
+	void OnRep_Activated();
 
 private:
+	bool bEffectsScheduled = false;
+
 	FVector NewStartPoint = FVector::ZeroVector;
-	FTimerHandle DestroyTimer;
+	FWallRunTimerHandle DestroyTimer;
 };
@@ -0,0 +1,344 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WallRunMath.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	constexpr uint32 WallRunMathTestFlags = EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+	constexpr float TestWalkableFloorZ = 0.71f;
+
+	// character code before the kernel, kept here as the reference behavior
+	namespace Legacy
+	{
+		void GetWallRunSideAndDirection(const FVector& HitNormal, const FVector& ActorRight, WallRunMath::ESide& runSide, FVector& Direction)
+		{
+			if (FVector::DotProduct(HitNormal, ActorRight) > 0.0f)
+			{
+				runSide = WallRunMath::ESide::Left;
+				Direction = FVector::CrossProduct(HitNormal, FVector::UpVector).GetSafeNormal();
+			}
+			else
+			{
+				runSide = WallRunMath::ESide::Right;
+				Direction = FVector::CrossProduct(FVector::UpVector, HitNormal).GetSafeNormal();
+			}
+		}
+
+		bool IsSurfaceWallRunable(const FVector& surfaceNormal, float WalkableFloorZ)
+		{
+			if (surfaceNormal.Z > WalkableFloorZ || surfaceNormal.Z < -0.005f)
+				return false;
+
+			return true;
+		}
+
+		bool AreRequaredKeysDown(WallRunMath::ESide side, float forwardAxis, float rightAxis)
+		{
+			if (forwardAxis < 0.1f)
+			{
+				return false;
+			}
+
+			if (side == WallRunMath::ESide::Left && rightAxis > 0.1f)
+			{
+				return false;
+			}
+
+			if (side == WallRunMath::ESide::Right && rightAxis < -0.1f)
+			{
+				return false;
+			}
+
+			return true;
+		}
+
+		FVector GetWallJumpVelocity(WallRunMath::ESide CurrentWallRunSide, const FVector& CurrentWallRunDirection, float jumpVelocity, bool bIsBoost)
+		{
+			FVector JumpDirrection = FVector::ZeroVector;
+
+			if (CurrentWallRunSide == WallRunMath::ESide::Right)
+			{
+				JumpDirrection = FVector::CrossProduct(CurrentWallRunDirection, FVector::UpVector).GetSafeNormal();
+			}
+			else
+			{
+				JumpDirrection = FVector::CrossProduct(FVector::UpVector, CurrentWallRunDirection).GetSafeNormal();
+			}
+
+			JumpDirrection += FVector::UpVector;
+
+			if (bIsBoost)
+			{
+				JumpDirrection += CurrentWallRunDirection;
+			}
+
+			return jumpVelocity * JumpDirrection.GetSafeNormal();
+		}
+	}
+
+	FVector RandomNormal(FRandomStream& Random)
+	{
+		return FVector(Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-0.2f, 0.9f)).GetSafeNormal();
+	}
+
+	FVector RandomRight(FRandomStream& Random)
+	{
+		return FVector(Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f), 0.0f).GetSafeNormal();
+	}
+
+	// random candidates in batch layout, roughly half of them are walls the character can run on
+	struct FCandidateData
+	{
+		TArray<float> NormalX, NormalY, NormalZ, RightX, RightY, RightZ, ForwardAxis, RightAxis;
+
+		FCandidateData(int32 Num, int32 Seed)
+		{
+			FRandomStream Random(Seed);
+			for (int32 i = 0; i < Num; ++i)
+			{
+				const FVector Normal = RandomNormal(Random);
+				const FVector Right = RandomRight(Random);
+				NormalX.Add((float)Normal.X); NormalY.Add((float)Normal.Y); NormalZ.Add((float)Normal.Z);
+				RightX.Add((float)Right.X); RightY.Add((float)Right.Y); RightZ.Add((float)Right.Z);
+				ForwardAxis.Add(Random.FRandRange(-1.0f, 1.0f));
+				RightAxis.Add(Random.FRandRange(-1.0f, 1.0f));
+			}
+		}
+
+		WallRunMath::FCandidateBatch GetBatch() const
+		{
+			return { NormalX, NormalY, NormalZ, RightX, RightY, RightZ, ForwardAxis, RightAxis };
+		}
+	};
+
+	struct FResultData
+	{
+		TArray<WallRunMath::ESide> Side;
+		TArray<float> DirectionX, DirectionY;
+		TArray<bool> bCanWallRun;
+
+		explicit FResultData(int32 Num)
+		{
+			Side.SetNumZeroed(Num);
+			DirectionX.SetNumZeroed(Num);
+			DirectionY.SetNumZeroed(Num);
+			bCanWallRun.SetNumZeroed(Num);
+		}
+
+		WallRunMath::FResultBatch GetBatch()
+		{
+			return { Side, DirectionX, DirectionY, bCanWallRun };
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWallRunMathSideAndDirectionTest, "WallRun.Math.SideAndDirection", WallRunMathTestFlags)
+
+bool FWallRunMathSideAndDirectionTest::RunTest(const FString& Parameters)
+{
+	WallRunMath::ESide Side = WallRunMath::ESide::None;
+	FVector Direction = FVector::ZeroVector;
+
+	// wall on the right of a character looking along X, normal points back at the character
+	WallRunMath::GetWallRunSideAndDirection(FVector(0.0f, -1.0f, 0.0f), FVector(0.0f, 1.0f, 0.0f), Side, Direction);
+	TestTrue(TEXT("Wall on the right"), Side == WallRunMath::ESide::Right);
+	TestEqual(TEXT("Run forward along right wall"), Direction, FVector(1.0f, 0.0f, 0.0f), KINDA_SMALL_NUMBER);
+
+	WallRunMath::GetWallRunSideAndDirection(FVector(0.0f, 1.0f, 0.0f), FVector(0.0f, 1.0f, 0.0f), Side, Direction);
+	TestTrue(TEXT("Wall on the left"), Side == WallRunMath::ESide::Left);
+	TestEqual(TEXT("Run forward along left wall"), Direction, FVector(1.0f, 0.0f, 0.0f), KINDA_SMALL_NUMBER);
+
+	// flat floor has no horizontal direction
+	WallRunMath::GetWallRunSideAndDirection(FVector::UpVector, FVector(0.0f, 1.0f, 0.0f), Side, Direction);
+	TestTrue(TEXT("Floor gives zero direction"), Direction.IsZero());
+
+	FRandomStream Random(27);
+	for (int32 i = 0; i < 1000; ++i)
+	{
+		const FVector Normal = RandomNormal(Random);
+		const FVector Right = RandomRight(Random);
+
+		WallRunMath::ESide ExpectedSide = WallRunMath::ESide::None;
+		FVector ExpectedDirection = FVector::ZeroVector;
+		Legacy::GetWallRunSideAndDirection(Normal, Right, ExpectedSide, ExpectedDirection);
+		WallRunMath::GetWallRunSideAndDirection(Normal, Right, Side, Direction);
+
+		if (!TestTrue(TEXT("Side matches character code"), Side == ExpectedSide)
+			|| !TestEqual(TEXT("Direction matches character code"), Direction, ExpectedDirection, KINDA_SMALL_NUMBER))
+		{
+			break;
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWallRunMathSurfaceTest, "WallRun.Math.IsSurfaceWallRunable", WallRunMathTestFlags)
+
+bool FWallRunMathSurfaceTest::RunTest(const FString& Parameters)
+{
+	TestTrue(TEXT("Vertical wall"), WallRunMath::IsSurfaceWallRunable(FVector(1.0f, 0.0f, 0.0f), TestWalkableFloorZ));
+	TestFalse(TEXT("Floor"), WallRunMath::IsSurfaceWallRunable(FVector::UpVector, TestWalkableFloorZ));
+	TestFalse(TEXT("Ceiling"), WallRunMath::IsSurfaceWallRunable(-FVector::UpVector, TestWalkableFloorZ));
+	TestTrue(TEXT("Walkable limit is runnable"), WallRunMath::IsSurfaceWallRunable(FVector(0.7f, 0.0f, TestWalkableFloorZ), TestWalkableFloorZ));
+	TestTrue(TEXT("Slight overhang"), WallRunMath::IsSurfaceWallRunable(FVector(1.0f, 0.0f, -0.005f), TestWalkableFloorZ));
+	TestFalse(TEXT("Overhang"), WallRunMath::IsSurfaceWallRunable(FVector(1.0f, 0.0f, -0.01f), TestWalkableFloorZ));
+
+	FRandomStream Random(28);
+	for (int32 i = 0; i < 1000; ++i)
+	{
+		const FVector Normal = RandomNormal(Random);
+		if (!TestTrue(TEXT("Matches character code"), WallRunMath::IsSurfaceWallRunable(Normal, TestWalkableFloorZ) == Legacy::IsSurfaceWallRunable(Normal, TestWalkableFloorZ)))
+		{
+			break;
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWallRunMathKeysTest, "WallRun.Math.AreRequaredKeysDown", WallRunMathTestFlags)
+
+bool FWallRunMathKeysTest::RunTest(const FString& Parameters)
+{
+	TestTrue(TEXT("Forward on right wall"), WallRunMath::AreRequaredKeysDown(WallRunMath::ESide::Right, 1.0f, 0.0f));
+	TestFalse(TEXT("No forward"), WallRunMath::AreRequaredKeysDown(WallRunMath::ESide::Right, 0.0f, 0.0f));
+	TestTrue(TEXT("Forward at threshold"), WallRunMath::AreRequaredKeysDown(WallRunMath::ESide::Left, 0.1f, 0.0f));
+	TestFalse(TEXT("Steering away from left wall"), WallRunMath::AreRequaredKeysDown(WallRunMath::ESide::Left, 1.0f, 1.0f));
+	TestTrue(TEXT("Steering into left wall"), WallRunMath::AreRequaredKeysDown(WallRunMath::ESide::Left, 1.0f, -1.0f));
+	TestFalse(TEXT("Steering away from right wall"), WallRunMath::AreRequaredKeysDown(WallRunMath::ESide::Right, 1.0f, -1.0f));
+	TestTrue(TEXT("Steering into right wall"), WallRunMath::AreRequaredKeysDown(WallRunMath::ESide::Right, 1.0f, 1.0f));
+
+	const WallRunMath::ESide Sides[] = { WallRunMath::ESide::None, WallRunMath::ESide::Right, WallRunMath::ESide::Left };
+	for (WallRunMath::ESide Side : Sides)
+	{
+		for (float Forward = -1.0f; Forward <= 1.0f; Forward += 0.05f)
+		{
+			for (float Right = -1.0f; Right <= 1.0f; Right += 0.05f)
+			{
+				if (WallRunMath::AreRequaredKeysDown(Side, Forward, Right) != Legacy::AreRequaredKeysDown(Side, Forward, Right))
+				{
+					AddError(FString::Printf(TEXT("Mismatch for side %d, forward %f, right %f"), (int32)Side, Forward, Right));
+					return true;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWallRunMathJumpTest, "WallRun.Math.GetWallJumpVelocity", WallRunMathTestFlags)
+
+bool FWallRunMathJumpTest::RunTest(const FString& Parameters)
+{
+	const float JumpZVelocity = 420.0f;
+
+	// running along X with wall on the right, jump goes left and up
+	const FVector Jump = WallRunMath::GetWallJumpVelocity(WallRunMath::ESide::Right, FVector(1.0f, 0.0f, 0.0f), JumpZVelocity, false);
+	TestEqual(TEXT("Jump away from right wall"), Jump, FVector(0.0f, -1.0f, 1.0f).GetSafeNormal() * JumpZVelocity, 0.01f);
+	TestEqual(TEXT("Jump speed"), (float)Jump.Size(), JumpZVelocity, 0.01f);
+
+	const FVector BoostJump = WallRunMath::GetWallJumpVelocity(WallRunMath::ESide::Left, FVector(1.0f, 0.0f, 0.0f), JumpZVelocity, true);
+	TestEqual(TEXT("Boost jump adds run direction"), BoostJump, FVector(1.0f, 1.0f, 1.0f).GetSafeNormal() * JumpZVelocity, 0.01f);
+
+	FRandomStream Random(29);
+	for (int32 i = 0; i < 1000; ++i)
+	{
+		const WallRunMath::ESide Side = Random.RandRange(0, 1) ? WallRunMath::ESide::Left : WallRunMath::ESide::Right;
+		const FVector Direction = RandomRight(Random);
+		const bool bIsBoost = Random.RandRange(0, 1) != 0;
+
+		if (!TestEqual(TEXT("Matches character code"),
+			WallRunMath::GetWallJumpVelocity(Side, Direction, JumpZVelocity, bIsBoost),
+			Legacy::GetWallJumpVelocity(Side, Direction, JumpZVelocity, bIsBoost), 0.01f))
+		{
+			break;
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWallRunMathBatchTest, "WallRun.Math.BatchSIMDMatchesScalar", WallRunMathTestFlags)
+
+bool FWallRunMathBatchTest::RunTest(const FString& Parameters)
+{
+	// sizes around the vector width, the tail goes through the scalar path
+	const int32 Sizes[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 17, 1023, 1025 };
+	for (int32 Num : Sizes)
+	{
+		const FCandidateData Data(Num, Num + 1);
+		FResultData Scalar(Num);
+		FResultData SIMD(Num);
+
+		WallRunMath::EvaluateBatchScalar(Data.GetBatch(), Scalar.GetBatch(), TestWalkableFloorZ);
+		WallRunMath::EvaluateBatchSIMD(Data.GetBatch(), SIMD.GetBatch(), TestWalkableFloorZ);
+
+		for (int32 i = 0; i < Num; ++i)
+		{
+			const bool bMatch = Scalar.Side[i] == SIMD.Side[i]
+				&& Scalar.bCanWallRun[i] == SIMD.bCanWallRun[i]
+				&& FMath::IsNearlyEqual(Scalar.DirectionX[i], SIMD.DirectionX[i], KINDA_SMALL_NUMBER)
+				&& FMath::IsNearlyEqual(Scalar.DirectionY[i], SIMD.DirectionY[i], KINDA_SMALL_NUMBER);
+			if (!bMatch)
+			{
+				AddError(FString::Printf(TEXT("Batch of %d differs at candidate %d"), Num, i));
+				break;
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWallRunMathBenchmark, "WallRun.Math.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FWallRunMathBenchmark::RunTest(const FString& Parameters)
+{
+	const int32 NumCandidates = 4096;
+	const int32 NumIterations = 200;
+
+	const FCandidateData Data(NumCandidates, NumCandidates);
+	const WallRunMath::FCandidateBatch In = Data.GetBatch();
+	FResultData Results(NumCandidates);
+
+	auto Measure = [NumCandidates, NumIterations](auto&& Function)
+	{
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			Function();
+		}
+		return FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles) * 1e9 / (double(NumCandidates) * NumIterations);
+	};
+
+	// one candidate per call, same as the character does
+	const double SingleNs = Measure([&]()
+	{
+		for (int32 i = 0; i < NumCandidates; ++i)
+		{
+			const FVector Normal(In.NormalX[i], In.NormalY[i], In.NormalZ[i]);
+			WallRunMath::ESide Side;
+			FVector Direction;
+			WallRunMath::GetWallRunSideAndDirection(Normal, FVector(In.RightX[i], In.RightY[i], In.RightZ[i]), Side, Direction);
+			Results.bCanWallRun[i] = WallRunMath::IsSurfaceWallRunable(Normal, TestWalkableFloorZ)
+				&& WallRunMath::AreRequaredKeysDown(Side, In.ForwardAxis[i], In.RightAxis[i]);
+		}
+	});
+	const double ScalarNs = Measure([&]() { WallRunMath::EvaluateBatchScalar(In, Results.GetBatch(), TestWalkableFloorZ); });
+	const double SIMDNs = Measure([&]() { WallRunMath::EvaluateBatchSIMD(In, Results.GetBatch(), TestWalkableFloorZ); });
+
+	AddInfo(FString::Printf(TEXT("%d candidates x %d iterations"), NumCandidates, NumIterations));
+	AddInfo(FString::Printf(TEXT("single: %.2f ns/eval, batch scalar: %.2f ns/eval, batch SIMD: %.2f ns/eval"), SingleNs, ScalarNs, SIMDNs));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WallRunMemory.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && ENABLE_LOW_LEVEL_MEM_TRACKER
+
+namespace
+{
+	const TCHAR* MemoryBudgetMap = TEXT("/Game/StarterContent/Maps/WallRunGym");
+}
+
+DEFINE_LATENT_AUTOMATION_COMMAND(FWallRunSpawnBudgetActorsCommand);
+
+bool FWallRunSpawnBudgetActorsCommand::Update()
+{
+	if (UWorld* World = AutomationCommon::GetAnyGameWorld())
+	{
+		WallRunMemory::SpawnBudgetActors(World);
+	}
+	return true;
+}
+
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FWallRunCheckMemoryBudgetsCommand, FAutomationTestBase*, Test);
+
+bool FWallRunCheckMemoryBudgetsCommand::Update()
+{
+	UWorld* World = AutomationCommon::GetAnyGameWorld();
+	if (World == nullptr)
+	{
+		Test->AddError(TEXT("No game world to check"));
+		return true;
+	}
+
+	if (!WallRunMemory::CheckMemoryBudgets(World))
+	{
+		Test->AddError(TEXT("WallRun memory budgets exceeded, see LogWallRunMemory"));
+	}
+	return true;
+}
+
+/**
+ * Loads WallRunGym, spawns the actor counts from [WallRun.MemoryBudgets] and fails if
+ * any WallRun LLM tag is over budget. Needs -llm, for headless runs:
+ *   -game -nullrhi -llm -ExecCmds="Automation RunTests WallRun.Memory.Budgets; Quit"
+ * Client only, in the editor AutomationOpenMap loads the map without a game world.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWallRunMemoryBudgetsTest, "WallRun.Memory.Budgets",
+	EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FWallRunMemoryBudgetsTest::RunTest(const FString& Parameters)
+{
+	if (!FLowLevelMemTracker::Get().IsEnabled())
+	{
+		AddError(TEXT("LLM is disabled, run with -llm"));
+		return false;
+	}
+
+	AutomationOpenMap(MemoryBudgetMap);
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitForMapToLoadCommand());
+	ADD_LATENT_AUTOMATION_COMMAND(FWallRunSpawnBudgetActorsCommand());
+	// LLM totals are collected at the end of the frame
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitLatentCommand(0.5f));
+	ADD_LATENT_AUTOMATION_COMMAND(FWallRunCheckMemoryBudgetsCommand(this));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && ENABLE_LOW_LEVEL_MEM_TRACKER
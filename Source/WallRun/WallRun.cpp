@@ -1,7 +1,21 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "WallRun.h"
+#include "WallRunTelemetry.h"
+#include "WallRunInputLatency.h"
 #include "Modules/ModuleManager.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, WallRun, "WallRun" );
- 
\ No newline at end of file
+class FWallRunModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void ShutdownModule() override
+	{
+		// local player registers it in a game world, it may still be there
+		FWallRunInputLatency::Unregister();
+
+		// write out events still in flight
+		FWallRunTelemetry::Get().Shutdown();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FWallRunModule, WallRun, "WallRun" );
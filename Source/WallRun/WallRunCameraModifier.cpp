@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WallRunCameraModifier.h"
+#include "WallRunCharacter.h"
+#include "WallRunInputLatency.h"
+#include "Curves/CurveFloat.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+bool UWallRunCameraModifier::ModifyCamera(float DeltaTime, FMinimalViewInfo& InOutPOV)
+{
+	Super::ModifyCamera(DeltaTime, InOutPOV);
+
+	AWallRunCharacter* Character = Cast<AWallRunCharacter>(GetViewTarget());
+
+	// modifiers run last, movement input and view here are what the player sees this frame
+	const FVector LocalMoveDirection = Character != nullptr
+		? Character->GetActorRotation().UnrotateVector(Character->GetCharacterMovement()->GetCurrentAcceleration())
+		: FVector::ZeroVector;
+	FWallRunInputLatency::Get().OnViewComputed(LocalMoveDirection, InOutPOV.Rotation);
+
+	const UCurveFloat* TiltCurve = Character != nullptr ? Character->GetCameraTiltCurve() : nullptr;
+	if (TiltCurve == nullptr)
+	{
+		TiltTime = 0.0f;
+		return false;
+	}
+
+	if (Character->IsWallRunning())
+	{
+		TiltSide = Character->GetWallRunSide();
+	}
+
+	float MinTime = 0.0f;
+	float MaxTime = 0.0f;
+	TiltCurve->GetTimeRange(MinTime, MaxTime);
+	TiltTime = FMath::Clamp(TiltTime + (Character->IsWallRunning() ? DeltaTime : -DeltaTime), MinTime, MaxTime);
+
+	const float TiltValue = TiltCurve->GetFloatValue(TiltTime);
+	const float Roll = TiltSide == WallRunSide::LEFT ? TiltValue : -TiltValue;
+	InOutPOV.Rotation.Roll += Roll;
+
+	// arms hang off the camera component which is not rolled, keep them still on screen
+	Character->SetArmsRoll(Roll);
+
+	return false;
+}
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera/CameraModifier.h"
+#include "WallRunCharacter.h"
+#include "WallRunCameraModifier.generated.h"
+
+/**
+ * Tilts the view while the view target is wall running.
+ * Roll comes from the character's CameraTiltCurv, the control rotation is not touched.
+ * First person arms get the same roll so they move with the view like before.
+ */
+UCLASS()
+class UWallRunCameraModifier : public UCameraModifier
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ModifyCamera(float DeltaTime, FMinimalViewInfo& InOutPOV) override;
+
+private:
+	// position on the tilt curve, goes forward while wall running and back after
+	float TiltTime = 0.0f;
+	// side is kept while tilt goes back after wall run
+	WallRunSide TiltSide = WallRunSide::NONE;
+};
@@ -2,6 +2,12 @@
 
 #include "WallRunCharacter.h"
 #include "WallRunProjectile.h"
+#include "WallRunCameraModifier.h"
+#include "WallRunTelemetry.h"
+#include "WallRunMemory.h"
+#include "WallRunGhostRecorderComponent.h"
+#include "WallRunGhostManager.h"
+#include "WallRunInputLatency.h"
 #include "Animation/AnimInstance.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
@@ -9,15 +15,29 @@
 #include "GameFramework/InputSettings.h"
 #include "HeadMountedDisplayFunctionLibrary.h"
 #include "Kismet/GameplayStatics.h"
+#include "EngineUtils.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Net/UnrealNetwork.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogFPChar, Warning, All);
 
+static TAutoConsoleVariable<float> CVarWallRunFixedStepHz(
+	TEXT("WallRun.FixedStepHz"),
+	120.0f,
+	TEXT("Rate of wall run steps (probe, steering, timeout), the same at any frame rate. 0 steps once per frame. Read when a wall run starts"));
+
+// steps done in one frame at most, the rest of a long hitch is dropped
+static constexpr int32 MaxWallRunStepsPerFrame = 8;
+
 //////////////////////////////////////////////////////////////////////////
 // AWallRunCharacter
 
 AWallRunCharacter::AWallRunCharacter()
 {
+	LLM_SCOPE_BYTAG(WallRunCharacter);
+
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(55.f, 96.0f);
 
@@ -52,6 +72,9 @@ AWallRunCharacter::AWallRunCharacter()
 	FP_MuzzleLocation->SetupAttachment(FP_Gun);
 	FP_MuzzleLocation->SetRelativeLocation(FVector(0.2f, 48.4f, -10.6f));
 
+	// Ghost recording of runs between checkpoints, locally controlled only
+	GhostRecorder = CreateDefaultSubobject<UWallRunGhostRecorderComponent>(TEXT("GhostRecorder"));
+
 	// Default offset from the character location for projectiles to spawn
 	GunOffset = FVector(100.0f, 0.0f, 10.0f);
 
@@ -65,42 +88,41 @@ void AWallRunCharacter::Tick(float Deltatime)
 
 	if (bIsWallRunning)
 	{
-		UpdateWallRun();
+		if (WallRunStepTime > 0.0f)
+		{
+			UpdateWallRunFixedStep(Deltatime);
+		}
+		else
+		{
+			UpdateWallRun();
+		}
 	}
 
-	CameraTiltTimeline.TickTimeline(Deltatime);
-
 	if (IsMustDie())
 	{
 		Die();
 	}
+	else
+	{
+		RecordSnapshot(Deltatime);
+	}
+}
+
+void AWallRunCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(AWallRunCharacter, bNetWallRunning, COND_SkipOwner);
 }
 
 void AWallRunCharacter::Jump()
 {
 	if (bIsWallRunning)
 	{
-		FVector JumpDirrection = FVector::ZeroVector;
-
-		if (CurrentWallRunSide == WallRunSide::RIGHT)
-		{
-			JumpDirrection = FVector::CrossProduct(CurrentWallRunDirection, FVector::UpVector).GetSafeNormal();
-		}
-		else
-		{
-			JumpDirrection = FVector::CrossProduct(FVector::UpVector, CurrentWallRunDirection).GetSafeNormal();
-		}
-
-		JumpDirrection += FVector::UpVector;
-		float jumpVelocity = GetCharacterMovement()->JumpZVelocity;
+		const float jumpVelocity = GetCharacterMovement()->JumpZVelocity;
 
-		if (bIsBoost)
-		{
-			JumpDirrection += CurrentWallRunDirection;
-		}
-		
-		LaunchCharacter(jumpVelocity * JumpDirrection.GetSafeNormal(), false, true);
-		StopWallRun();
+		LaunchCharacter(WallRunMath::GetWallJumpVelocity(ToMathSide(CurrentWallRunSide), CurrentWallRunDirection, jumpVelocity, bIsBoost), false, true);
+		StopWallRun(EWallRunStopReason::Jump);
 	}
 	else
 	{
@@ -110,14 +132,45 @@ void AWallRunCharacter::Jump()
 
 void AWallRunCharacter::Die()
 {
-	StopWallRun();
+	// simulated proxies and replay pawns die too, only the player's own deaths are telemetry
+	if (IsLocallyControlled())
+	{
+		FWallRunTelemetry::Record(EWallRunTelemetryEvent::Death, this, GetWorld()->GetTimeSeconds());
+	}
+
+	RestoreSnapshot(CheckpointSnapshot);
+
+	// back at the start of the run
+	GhostRecorder->RestartRun();
+}
+
+void AWallRunCharacter::Rewind(float Seconds)
+{
+	if (SnapshotHistory.IsEmpty())
+	{
+		return;
+	}
 
-	SetActorLocation(checpoint);
-	GetController()->SetControlRotation(startRatate);
+	// newest snapshot not younger than requested time, or the oldest one we have
+	const float TargetTime = GetWorld()->GetTimeSeconds() - Seconds;
+	int32 Index = 0;
+	while (Index < SnapshotHistory.Num() - 1 && SnapshotHistory.GetFromNewest(Index).Time > TargetTime)
+	{
+		++Index;
+	}
+
+	RestoreSnapshot(SnapshotHistory.GetFromNewest(Index));
+	SnapshotHistory.DiscardNewest(Index);
+	SnapshotAccumulator = 0.0f;
+
+	// a rewound run is not a ghost, next one starts on death or checkpoint
+	GhostRecorder->CancelRun();
 }
 
 void AWallRunCharacter::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(WallRunCharacter);
+
 	// Call the base class  
 	Super::BeginPlay();
 
@@ -125,24 +178,80 @@ void AWallRunCharacter::BeginPlay()
 
 	GetCapsuleComponent()->OnComponentHit.AddDynamic(this, &AWallRunCharacter::OnCharacterCapsulHit);
 
+	// movement runs after Tick, so wall run steering from this frame input moves the character this frame, not the next one
+	GetCharacterMovement()->PrimaryComponentTick.AddPrerequisite(this, PrimaryActorTick);
+
 	//Attach gun mesh component to Skeleton, doing it here because the skeleton is not yet created in the constructor
 	FP_Gun->AttachToComponent(Mesh1P, FAttachmentTransformRules(EAttachmentRule::SnapToTarget, true), TEXT("GripPoint"));
-
-	// setup camera tilt
-	if (IsValid(CameraTiltCurv))
-	{
-		FOnTimelineFloat TimeLineCallBack;
-		TimeLineCallBack.BindUFunction(this, FName("UpdateCameraTilt"));
-		CameraTiltTimeline.AddInterpFloat(CameraTiltCurv, TimeLineCallBack);
-	}
+	Mesh1PRelativeTransform = Mesh1P->GetRelativeTransform();
 
 	// set velosity for boost
 	standartSpeed = GetCharacterMovement()->MaxWalkSpeed;
 	boostSpeed = standartSpeed * BoostScale;
 
 	// set start point
-	checpoint = GetActorLocation();
-	startRatate = GetControlRotation();
+	SaveCheckpoint(GetActorLocation(), GetControlRotation(), DeadlyHeight);
+}
+
+void AWallRunCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (IsLocallyControlled())
+	{
+		FWallRunInputLatency::Unregister();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AWallRunCharacter::PawnClientRestart()
+{
+	Super::PawnClientRestart();
+
+	// camera tilt while wall running
+	APlayerController* PlayerController = Cast<APlayerController>(Controller);
+	if (PlayerController != nullptr && PlayerController->PlayerCameraManager != nullptr)
+	{
+		if (PlayerController->PlayerCameraManager->FindCameraModifierByClass(UWallRunCameraModifier::StaticClass()) == nullptr)
+		{
+			PlayerController->PlayerCameraManager->AddNewCameraModifier(UWallRunCameraModifier::StaticClass());
+		}
+	}
+
+	// latency of the local player's input, game worlds only
+	FWallRunInputLatency::Register();
+
+	// ghosts are local, one manager per client
+	if (!TActorIterator<AWallRunGhostManager>(GetWorld()))
+	{
+		GetWorld()->SpawnActor<AWallRunGhostManager>();
+	}
+
+	GhostRecorder->StartRun(GetGhostRunName(TEXT("Start")));
+}
+
+void AWallRunCharacter::StartGhostRun(const FString& StartName)
+{
+	GhostRecorder->CompleteRun();
+	GhostRecorder->StartRun(GetGhostRunName(StartName));
+}
+
+FString AWallRunCharacter::GetGhostRunName(const FString& StartName) const
+{
+	return FString::Printf(TEXT("%s.%s"), *UWorld::RemovePIEPrefix(GetWorld()->GetMapName()), *StartName);
+}
+
+void AWallRunCharacter::SetArmsRoll(float Roll)
+{
+	// modifier calls it every frame, a tiny change is not worth a transform update,
+	// going back to no roll is always applied so the arms end where they started
+	if (Roll == ArmsRoll || (Roll != 0.0f && FMath::IsNearlyEqual(Roll, ArmsRoll, 0.01f)))
+	{
+		return;
+	}
+
+	ArmsRoll = Roll;
+	// relative to the camera, so roll goes after the blueprint placement
+	Mesh1P->SetRelativeTransform(Mesh1PRelativeTransform * FTransform(FRotator(0.0f, 0.0f, Roll)));
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -164,6 +273,9 @@ void AWallRunCharacter::SetupPlayerInputComponent(class UInputComponent* PlayerI
 	PlayerInputComponent->BindAction("Boost", IE_Pressed, this, &AWallRunCharacter::BoostActivate);
 	PlayerInputComponent->BindAction("Boost", IE_Released, this, &AWallRunCharacter::BoostEnd);
 
+	// Bind rewind event
+	PlayerInputComponent->BindAction("Rewind", IE_Pressed, this, &AWallRunCharacter::RewindPressed);
+
 	// Bind movement events
 	PlayerInputComponent->BindAxis("MoveForward", this, &AWallRunCharacter::MoveForward);
 	PlayerInputComponent->BindAxis("MoveRight", this, &AWallRunCharacter::MoveRight);
@@ -179,22 +291,22 @@ void AWallRunCharacter::SetupPlayerInputComponent(class UInputComponent* PlayerI
 
 void AWallRunCharacter::OnFire()
 {
+	FWallRunTelemetry::Record(EWallRunTelemetryEvent::Shot, this);
+
 	// try and fire a projectile
 	if (ProjectileClass != nullptr)
 	{
-		UWorld* const World = GetWorld();
-		if (World != nullptr)
-		{
-			const FRotator SpawnRotation = GetControlRotation();
-			// MuzzleOffset is in camera space, so transform it to world space before offsetting from the character location to find the final muzzle position
-			const FVector SpawnLocation = ((FP_MuzzleLocation != nullptr) ? FP_MuzzleLocation->GetComponentLocation() : GetActorLocation()) + SpawnRotation.RotateVector(GunOffset);
+		const FRotator SpawnRotation = GetControlRotation();
+		// MuzzleOffset is in camera space, so transform it to world space before offsetting from the character location to find the final muzzle position
+		const FVector SpawnLocation = ((FP_MuzzleLocation != nullptr) ? FP_MuzzleLocation->GetComponentLocation() : GetActorLocation()) + SpawnRotation.RotateVector(GunOffset);
 
-			//Set Spawn Collision Handling Override
-			FActorSpawnParameters ActorSpawnParams;
-			ActorSpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
-
-			// spawn the projectile at the muzzle
-			World->SpawnActor<AWallRunProjectile>(ProjectileClass, SpawnLocation, SpawnRotation, ActorSpawnParams);
+		if (HasAuthority())
+		{
+			SpawnProjectile(SpawnLocation, SpawnRotation);
+		}
+		else
+		{
+			ServerFire(SpawnLocation, SpawnRotation);
 		}
 	}
 
@@ -286,119 +398,233 @@ void AWallRunCharacter::OnCharacterCapsulHit(UPrimitiveComponent* HitComponent,
 
 void AWallRunCharacter::GetWallRunSideAndDirection(const FVector& HitNormal, WallRunSide& runSide, FVector& Direction) const
 {
-	if (FVector::DotProduct(HitNormal, GetActorRightVector()) > 0.0f)
-	{
-		runSide = WallRunSide::LEFT;
-		Direction = FVector::CrossProduct(HitNormal, FVector::UpVector).GetSafeNormal();
-	}
-	else
-	{
-		runSide = WallRunSide::RIGHT;
-		Direction = FVector::CrossProduct(FVector::UpVector, HitNormal).GetSafeNormal();
-	}
+	WallRunMath::ESide Side = WallRunMath::ESide::None;
+	WallRunMath::GetWallRunSideAndDirection(HitNormal, GetActorRightVector(), Side, Direction);
+	runSide = FromMathSide(Side);
 }
 
 bool AWallRunCharacter::IsSurfaceWallRunable(const FVector& surfaceNormal) const
 {
-	if (surfaceNormal.Z > GetCharacterMovement()->GetWalkableFloorZ() || surfaceNormal.Z < -0.005f)
-		return false;
-
-	return true;
+	return WallRunMath::IsSurfaceWallRunable(surfaceNormal, GetCharacterMovement()->GetWalkableFloorZ());
 }
 
 bool AWallRunCharacter::AreRequaredKeysDown(WallRunSide side) const
 {
-	if (forwardAxis < 0.1f)
-	{
-		return false;
-	}
-
-	if (side == WallRunSide::LEFT && rightAxis > 0.1f)
-	{
-		return false;
-	}
-
-	if (side == WallRunSide::RIGHT && rightAxis < -0.1f)
-	{
-		return false;
-	}
-
-	return true;
+	return WallRunMath::AreRequaredKeysDown(ToMathSide(side), forwardAxis, rightAxis);
 }
 
 void AWallRunCharacter::StartWallRun(WallRunSide side, const FVector& direction)
 {
-	BeginCameraTilt();
-
 	bIsWallRunning = true;
+	SetNetWallRunning(true);
 	CurrentWallRunDirection = direction;
 	CurrentWallRunSide = side;
 
 	GetCharacterMovement()->SetPlaneConstraintNormal(FVector::UpVector);
 
-	GetWorld()->GetTimerManager().SetTimer(WallRunTimer, this, &AWallRunCharacter::StopWallRun, MaxWallRunTime, false);
+	StartWallRunTimeout(MaxWallRunTime);
+
+	WallRunStartTime = GetWorld()->GetTimeSeconds();
+	FWallRunTelemetry::Record(EWallRunTelemetryEvent::WallRunStart, this, (float)side);
 }
 
-void AWallRunCharacter::StopWallRun()
+void AWallRunCharacter::StopWallRun(EWallRunStopReason Reason)
 {
-	EndCameraTilt();
+	FWallRunTelemetry::Record(EWallRunTelemetryEvent::WallRunStop, this, GetWorld()->GetTimeSeconds() - WallRunStartTime, Reason);
 
 	bIsWallRunning = false;
+	SetNetWallRunning(false);
 
 	GetCharacterMovement()->SetPlaneConstraintNormal(FVector::ZeroVector);
 
 	StartReloadingWallRun();
 }
 
+void AWallRunCharacter::WallRunTimeout()
+{
+	StopWallRun(EWallRunStopReason::Timeout);
+}
+
 void AWallRunCharacter::UpdateWallRun()
+{
+	if (StepWallRun(GetActorLocation()))
+	{
+		GetCharacterMovement()->Velocity = GetCharacterMovement()->GetMaxSpeed() * CurrentWallRunDirection;
+	}
+}
+
+void AWallRunCharacter::UpdateWallRunFixedStep(float DeltaTime)
+{
+	// capsule stopped short of the last target, move the simulated path with it
+	const FVector Correction = GetActorLocation() - WallRunStepTarget;
+	WallRunStepPrevious += Correction;
+	WallRunStepCurrent += Correction;
+
+	WallRunStepAccumulator += DeltaTime;
+	int32 Steps = 0;
+	while (WallRunStepAccumulator >= WallRunStepTime)
+	{
+		if (Steps == MaxWallRunStepsPerFrame)
+		{
+			WallRunStepAccumulator = 0.0f;
+			break;
+		}
+		WallRunStepAccumulator -= WallRunStepTime;
+		++Steps;
+
+		WallRunStepPrevious = WallRunStepCurrent;
+		if (!StepWallRun(WallRunStepCurrent))
+		{
+			return;
+		}
+
+		WallRunStepElapsed += WallRunStepTime;
+		if (WallRunStepElapsed >= MaxWallRunTime)
+		{
+			StopWallRun(EWallRunStopReason::Timeout);
+			return;
+		}
+		WallRunStepCurrent += GetCharacterMovement()->GetMaxSpeed() * WallRunStepTime * CurrentWallRunDirection;
+	}
+
+	// movement moves the capsule to the point between the last two steps this frame
+	WallRunStepTarget = FMath::Lerp(WallRunStepPrevious, WallRunStepCurrent, WallRunStepAccumulator / WallRunStepTime);
+	if (DeltaTime > 0.0f)
+	{
+		GetCharacterMovement()->Velocity = (WallRunStepTarget - GetActorLocation()) / DeltaTime;
+	}
+}
+
+bool AWallRunCharacter::StepWallRun(const FVector& Location)
 {
 	if (!AreRequaredKeysDown(CurrentWallRunSide))
 	{
-		StopWallRun();
-		return;
+		StopWallRun(EWallRunStopReason::KeyRelease);
+		return false;
 	}
 
 	FHitResult lineTraceResult;
-	
+	if (!ProbeWall(Location, lineTraceResult))
+	{
+		StopWallRun(EWallRunStopReason::LostWall);
+		return false;
+	}
+
+	WallRunSide newRunSide = WallRunSide::NONE;
+	FVector newDirection = FVector::ZeroVector;
+
+	GetWallRunSideAndDirection(lineTraceResult.Normal, newRunSide, newDirection);
+
+	if (newRunSide != CurrentWallRunSide)
+	{
+		StopWallRun(EWallRunStopReason::SideChange);
+		return false;
+	}
+
+	CurrentWallRunDirection = newDirection;
+	return true;
+}
+
+bool AWallRunCharacter::ProbeWall(const FVector& Location, FHitResult& OutHit) const
+{
 	FVector lineTraceDirection = CurrentWallRunSide == WallRunSide::RIGHT ? GetActorRightVector() : -GetActorRightVector();
 	float lineTraceDistance = 200.0f;
 
-	FVector startTrace = GetActorLocation();
+	FVector startTrace = Location;
 	FVector endTrace = startTrace + lineTraceDirection * lineTraceDistance;
 
 	FCollisionQueryParams traceParams;
 	traceParams.AddIgnoredActor(this);
 
-	if (GetWorld()->LineTraceSingleByChannel(lineTraceResult, startTrace, endTrace, ECC_Visibility, traceParams))
+	return GetWorld()->LineTraceSingleByChannel(OutHit, startTrace, endTrace, ECC_Visibility, traceParams);
+}
+
+void AWallRunCharacter::StartWallRunTimeout(float TimeLeft)
+{
+	const float StepHz = CVarWallRunFixedStepHz.GetValueOnGameThread();
+	WallRunStepTime = StepHz > 0.0f ? 1.0f / StepHz : 0.0f;
+
+	if (WallRunStepTime > 0.0f)
+	{
+		// fixed steps count the time, simulated path starts at the capsule
+		WallRunStepElapsed = MaxWallRunTime - TimeLeft;
+		WallRunStepAccumulator = 0.0f;
+		WallRunStepPrevious = GetActorLocation();
+		WallRunStepCurrent = WallRunStepPrevious;
+		WallRunStepTarget = WallRunStepPrevious;
+	}
+	else
 	{
-		WallRunSide newRunSide = WallRunSide::NONE;
-		FVector newDirection = FVector::ZeroVector;
+		GetTimingWheel().SetTimer(WallRunTimer, this, &AWallRunCharacter::WallRunTimeouts, TimeLeft);
+	}
+}
 
-		GetWallRunSideAndDirection(lineTraceResult.Normal, newRunSide, newDirection);
+float AWallRunCharacter::GetWallRunTimeLeft() const
+{
+	if (WallRunStepTime > 0.0f)
+	{
+		return bIsWallRunning ? MaxWallRunTime - WallRunStepElapsed : -1.0f;
+	}
 
-		if (newRunSide != CurrentWallRunSide)
-		{
-			StopWallRun();
-			GetWorld()->GetTimerManager().ClearTimer(WallRunTimer);
-		}
-		else
-		{
-			CurrentWallRunDirection = newDirection;
-			GetCharacterMovement()->Velocity = GetCharacterMovement()->GetMaxSpeed() * CurrentWallRunDirection;
-		}
+	return GetTimingWheel().GetTimerRemaining(WallRunTimer);
+}
 
+void AWallRunCharacter::SetNetWallRunning(bool bNewWallRunning)
+{
+	// only the owner has the input to run on walls, server copies of remote pawns never do
+	if (!IsLocallyControlled() || bNetWallRunning == bNewWallRunning)
+	{
+		return;
 	}
-	else
+
+	bNetWallRunning = bNewWallRunning;
+	if (!HasAuthority())
+	{
+		ServerSetWallRunning(bNewWallRunning);
+	}
+}
+
+void AWallRunCharacter::ServerSetWallRunning_Implementation(bool bNewWallRunning)
+{
+	bNetWallRunning = bNewWallRunning;
+}
+
+void AWallRunCharacter::ServerFire_Implementation(FVector_NetQuantize SpawnLocation, FRotator SpawnRotation)
+{
+	// muzzle is next to the character, anything else is not a shot of this character
+	const float MaxMuzzleDistance = 300.0f;
+	if (FVector::DistSquared(SpawnLocation, GetActorLocation()) > FMath::Square(MaxMuzzleDistance))
 	{
-		StopWallRun();
+		return;
 	}
+
+	SpawnProjectile(SpawnLocation, SpawnRotation);
+}
+
+void AWallRunCharacter::SpawnProjectile(const FVector& SpawnLocation, const FRotator& SpawnRotation)
+{
+	UWorld* const World = GetWorld();
+	if (ProjectileClass == nullptr || World == nullptr)
+	{
+		return;
+	}
+
+	//Set Spawn Collision Handling Override
+	FActorSpawnParameters ActorSpawnParams;
+	ActorSpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
+	ActorSpawnParams.Owner = this;
+	ActorSpawnParams.Instigator = this;
+
+	// spawn the projectile at the muzzle
+	LLM_SCOPE_BYTAG(WallRunProjectile);
+	World->SpawnActor<AWallRunProjectile>(ProjectileClass, SpawnLocation, SpawnRotation, ActorSpawnParams);
 }
 
 void AWallRunCharacter::StartReloadingWallRun()
 {
 	bIsWallRunAvaible = false;
-	GetWorld()->GetTimerManager().ClearTimer(WallRunTimer);
-	GetWorld()->GetTimerManager().SetTimer(WallRunReloadTimer, this, &AWallRunCharacter::EndReloadingWallRun, ReloadingWallRunTime, false);
+	GetTimingWheel().ClearTimer(WallRunTimer);
+	GetTimingWheel().SetTimer(WallRunReloadTimer, this, &AWallRunCharacter::EndReloadingWallRuns, ReloadingWallRunTime);
 }
 
 void AWallRunCharacter::EndReloadingWallRun()
@@ -406,33 +632,141 @@ void AWallRunCharacter::EndReloadingWallRun()
 	bIsWallRunAvaible = true;
 }
 
-void AWallRunCharacter::UpdateCameraTilt(float value)
+void AWallRunCharacter::WallRunTimeouts(TArrayView<UObject* const> Characters)
+{
+	for (UObject* Character : Characters)
+	{
+		CastChecked<AWallRunCharacter>(Character)->WallRunTimeout();
+	}
+}
+
+void AWallRunCharacter::EndReloadingWallRuns(TArrayView<UObject* const> Characters)
 {
-	FRotator CurrentControlRotation = GetControlRotation();
-	CurrentControlRotation.Roll = CurrentWallRunSide == WallRunSide::LEFT ? value : -value;
-	GetController()->SetControlRotation(CurrentControlRotation);
+	for (UObject* Character : Characters)
+	{
+		CastChecked<AWallRunCharacter>(Character)->EndReloadingWallRun();
+	}
+}
+
+UWallRunTimingWheel& AWallRunCharacter::GetTimingWheel() const
+{
+	UWallRunTimingWheel* TimingWheel = GetWorld()->GetSubsystem<UWallRunTimingWheel>();
+	check(TimingWheel);
+	return *TimingWheel;
 }
 
 void AWallRunCharacter::SaveCheckpoint(const FVector& position, const FRotator& newRotation, float newDeadlyHeight)
 {
-	checpoint = position; 
-	startRatate = newRotation;
 	DeadlyHeight = newDeadlyHeight;
+
+	// retry always starts from the same clean state
+	CheckpointSnapshot = FWallRunSnapshot();
+	CheckpointSnapshot.Location = position;
+	CheckpointSnapshot.ControlRotation = newRotation;
+	CheckpointSnapshot.DeadlyHeight = newDeadlyHeight;
 }
 
 void AWallRunCharacter::BoostActivate()
 {
 	bIsBoost = true; 
 	GetCharacterMovement()->MaxWalkSpeed = boostSpeed;
+
+	BoostStartTime = GetWorld()->GetTimeSeconds();
+	FWallRunTelemetry::Record(EWallRunTelemetryEvent::BoostStart, this);
 }
 
 void AWallRunCharacter::BoostEnd()
 {
 	bIsBoost = false;  
 	GetCharacterMovement()->MaxWalkSpeed = standartSpeed;
+
+	FWallRunTelemetry::Record(EWallRunTelemetryEvent::BoostEnd, this, GetWorld()->GetTimeSeconds() - BoostStartTime);
 }
 
 bool AWallRunCharacter::IsMustDie()
 {
 	return GetActorLocation().Z <= DeadlyHeight;
 }
+
+void AWallRunCharacter::RecordSnapshot(float Deltatime)
+{
+	SnapshotAccumulator += Deltatime;
+	if (SnapshotAccumulator < SnapshotInterval)
+	{
+		return;
+	}
+
+	SnapshotAccumulator = FMath::Fmod(SnapshotAccumulator, SnapshotInterval);
+	SnapshotHistory.Push(MakeSnapshot());
+}
+
+FWallRunSnapshot AWallRunCharacter::MakeSnapshot() const
+{
+	const UCharacterMovementComponent* Movement = GetCharacterMovement();
+
+	FWallRunSnapshot Snapshot;
+	Snapshot.Time = GetWorld()->GetTimeSeconds();
+	Snapshot.Location = GetActorLocation();
+	Snapshot.ControlRotation = GetControlRotation();
+	Snapshot.Velocity = Movement->Velocity;
+	Snapshot.MovementMode = Movement->MovementMode;
+	Snapshot.bIsWallRunning = bIsWallRunning;
+	Snapshot.bIsWallRunAvaible = bIsWallRunAvaible;
+	Snapshot.bIsBoost = bIsBoost;
+	Snapshot.CurrentWallRunSide = CurrentWallRunSide;
+	Snapshot.CurrentWallRunDirection = CurrentWallRunDirection;
+	Snapshot.DeadlyHeight = DeadlyHeight;
+	Snapshot.WallRunTimeLeft = GetWallRunTimeLeft();
+	Snapshot.WallRunReloadTimeLeft = GetTimingWheel().GetTimerRemaining(WallRunReloadTimer);
+	return Snapshot;
+}
+
+void AWallRunCharacter::RestoreSnapshot(const FWallRunSnapshot& Snapshot)
+{
+	UCharacterMovementComponent* Movement = GetCharacterMovement();
+	UWallRunTimingWheel& TimingWheel = GetTimingWheel();
+
+	SetActorLocation(Snapshot.Location, false, nullptr, ETeleportType::TeleportPhysics);
+	if (Controller != nullptr)
+	{
+		Controller->SetControlRotation(Snapshot.ControlRotation);
+	}
+
+	Movement->SetMovementMode(Snapshot.MovementMode);
+	Movement->Velocity = Snapshot.Velocity;
+
+	// wall run state, a restored wall run is a new run for telemetry
+	if (bIsWallRunning)
+	{
+		FWallRunTelemetry::Record(EWallRunTelemetryEvent::WallRunStop, this, GetWorld()->GetTimeSeconds() - WallRunStartTime, EWallRunStopReason::Restore);
+	}
+	if (Snapshot.bIsWallRunning)
+	{
+		WallRunStartTime = GetWorld()->GetTimeSeconds();
+		FWallRunTelemetry::Record(EWallRunTelemetryEvent::WallRunStart, this, (float)Snapshot.CurrentWallRunSide);
+	}
+	bIsWallRunning = Snapshot.bIsWallRunning;
+	SetNetWallRunning(bIsWallRunning);
+	bIsWallRunAvaible = Snapshot.bIsWallRunAvaible;
+	CurrentWallRunSide = Snapshot.CurrentWallRunSide;
+	CurrentWallRunDirection = Snapshot.CurrentWallRunDirection;
+	Movement->SetPlaneConstraintNormal(bIsWallRunning ? FVector::UpVector : FVector::ZeroVector);
+
+	// boost state
+	bIsBoost = Snapshot.bIsBoost;
+	Movement->MaxWalkSpeed = bIsBoost ? boostSpeed : standartSpeed;
+
+	DeadlyHeight = Snapshot.DeadlyHeight;
+
+	// pending timers
+	TimingWheel.ClearTimer(WallRunTimer);
+	TimingWheel.ClearTimer(WallRunReloadTimer);
+	if (Snapshot.bIsWallRunning)
+	{
+		StartWallRunTimeout(Snapshot.WallRunTimeLeft);
+	}
+	if (Snapshot.WallRunReloadTimeLeft > 0.0f)
+	{
+		TimingWheel.SetTimer(WallRunReloadTimer, this, &AWallRunCharacter::EndReloadingWallRuns, Snapshot.WallRunReloadTimeLeft);
+	}
+}
@@ -4,7 +4,9 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
-#include "Components/TimelineComponent.h"
+#include "WallRunSnapshotRing.h"
+#include "WallRunMath.h"
+#include "WallRunTimingWheel.h"
 #include "WallRunCharacter.generated.h"
 
 class UInputComponent;
@@ -14,6 +16,9 @@ class UCameraComponent;
 class UMotionControllerComponent;
 class UAnimMontage;
 class USoundBase;
+class UCurveFloat;
+class UWallRunGhostRecorderComponent;
+enum class EWallRunStopReason : uint8;
 
 UENUM()
 enum class WallRunSide : uint8
@@ -23,6 +28,33 @@ enum class WallRunSide : uint8
 	LEFT
 };
 
+// math kernel uses its own enum with the same values
+FORCEINLINE WallRunMath::ESide ToMathSide(WallRunSide Side) { return static_cast<WallRunMath::ESide>(Side); }
+FORCEINLINE WallRunSide FromMathSide(WallRunMath::ESide Side) { return static_cast<WallRunSide>(Side); }
+
+// compact copy of character and movement state, used for retry from checkpoint and rewind
+struct FWallRunSnapshot
+{
+	float Time = 0.0f;
+
+	FVector Location = FVector::ZeroVector;
+	FRotator ControlRotation = FRotator::ZeroRotator;
+	FVector Velocity = FVector::ZeroVector;
+	TEnumAsByte<EMovementMode> MovementMode = MOVE_Falling;
+
+	bool bIsWallRunning = false;
+	bool bIsWallRunAvaible = true;
+	bool bIsBoost = false;
+	WallRunSide CurrentWallRunSide = WallRunSide::NONE;
+	FVector CurrentWallRunDirection = FVector::ZeroVector;
+
+	float DeadlyHeight = 0.0f;
+
+	// remaining timer time, negative when timer is not active
+	float WallRunTimeLeft = -1.0f;
+	float WallRunReloadTimeLeft = -1.0f;
+};
+
 UCLASS(config = Game)
 class AWallRunCharacter : public ACharacter
 {
@@ -44,16 +76,27 @@ class AWallRunCharacter : public ACharacter
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 		UCameraComponent* FirstPersonCameraComponent;
 
+	/** Records this character's runs for ghost races */
+	UPROPERTY(VisibleDefaultsOnly, Category = Ghost)
+		UWallRunGhostRecorderComponent* GhostRecorder;
+
 public:
 	AWallRunCharacter();
 	virtual void Tick(float Deltatime) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	virtual void Jump() override;
 	void Die();
+	// go back in time using recorded snapshots
+	void Rewind(float Seconds);
 	// set new chackpoint
 	void SaveCheckpoint(const FVector& position, const FRotator& newRotation, float newDeadlyHeight);
+	// keep the ghost of the run that ends here and start the next one
+	void StartGhostRun(const FString& StartName);
 
 protected:
 	virtual void BeginPlay();
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void PawnClientRestart() override;
 
 public:
 	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
@@ -111,7 +154,7 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wall Run", meta = (UIMin = 0.0f, ClampMin = 0.0f))
 	float ReloadingWallRunTime = 1.0f;
 
-	// property from tilt camera WallRun
+	// property from tilt camera WallRun, applied by UWallRunCameraModifier
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Wall Run")
 	UCurveFloat* CameraTiltCurv;
 
@@ -122,6 +165,14 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Movement")
 	float DeadlyHeight = 0.0f;
 
+	// time between recorded snapshots, history length is SnapshotInterval * SnapshotCapacity
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Retry", meta = (UIMin = 0.001f, ClampMin = 0.001f))
+	float SnapshotInterval = 1.0f / 60.0f;
+
+	// how far the Rewind action goes back
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Retry", meta = (UIMin = 0.0f, ClampMin = 0.0f))
+	float RewindSeconds = 2.0f;
+
 protected:
 	// APawn interface
 	virtual void SetupPlayerInputComponent(UInputComponent* InputComponent) override;
@@ -132,8 +183,21 @@ public:
 	USkeletalMeshComponent* GetMesh1P() const { return Mesh1P; }
 	/** Returns FirstPersonCameraComponent subobject **/
 	UCameraComponent* GetFirstPersonCameraComponent() const { return FirstPersonCameraComponent; }
+	/** Returns true while running along a wall **/
+	bool IsWallRunning() const { return bIsWallRunning; }
+	/** Returns wall run state sent by the owning client, valid on server and other clients **/
+	bool IsNetWallRunning() const { return bNetWallRunning; }
+	/** Returns side of the current or last wall run **/
+	WallRunSide GetWallRunSide() const { return CurrentWallRunSide; }
+	/** Returns curve for camera tilt while wall running **/
+	UCurveFloat* GetCameraTiltCurve() const { return CameraTiltCurv; }
+	/** Rolls first person arms and gun around the view axis, used with camera tilt **/
+	void SetArmsRoll(float Roll);
 
 private:
+	// ghost files and races are matched by map and start point
+	FString GetGhostRunName(const FString& StartName) const;
+
 	// character capsul hit handler
 	UFUNCTION()
 	void OnCharacterCapsulHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
@@ -148,16 +212,23 @@ private:
 
 	// wall run metods
 	void StartWallRun(WallRunSide side, const FVector& direction);
-	void StopWallRun();
+	void StopWallRun(EWallRunStopReason Reason);
+	void WallRunTimeout();
 	void UpdateWallRun();
+	// probe, steering and timeout in steps of WallRun.FixedStepHz, same path at any frame rate
+	void UpdateWallRunFixedStep(float DeltaTime);
+	// one step at Location, false when the wall run stopped
+	bool StepWallRun(const FVector& Location);
+	bool ProbeWall(const FVector& Location, FHitResult& OutHit) const;
+	void StartWallRunTimeout(float TimeLeft);
+	float GetWallRunTimeLeft() const;
 	void StartReloadingWallRun();
 	void EndReloadingWallRun();
 
-	// camera tilt metods
-	FORCEINLINE void BeginCameraTilt() { CameraTiltTimeline.Play(); }
-	UFUNCTION()
-	void UpdateCameraTilt(float value);
-	FORCEINLINE void EndCameraTilt() { CameraTiltTimeline.Reverse(); }
+	// timing wheel callbacks, one call for all characters expiring on the same tick
+	static void WallRunTimeouts(TArrayView<UObject* const> Characters);
+	static void EndReloadingWallRuns(TArrayView<UObject* const> Characters);
+	UWallRunTimingWheel& GetTimingWheel() const;
 
 	// for boost running and jump while wallRun
 	void BoostActivate();
@@ -166,6 +237,17 @@ private:
 	// checking die
 	bool IsMustDie();
 
+	// snapshots metods
+	void RewindPressed() { Rewind(RewindSeconds); }
+	void RecordSnapshot(float Deltatime);
+	FWallRunSnapshot MakeSnapshot() const;
+	void RestoreSnapshot(const FWallRunSnapshot& Snapshot);
+
+	// arms placement from the blueprint, camera tilt rolls on top of it
+	FTransform Mesh1PRelativeTransform;
+	// last roll given to the arms, transform is only written when it changes
+	float ArmsRoll = 0.0f;
+
 	// moving axises value from check wall run
 	float forwardAxis = 0.0f;
 	float rightAxis = 0.0f;
@@ -176,19 +258,46 @@ private:
 	WallRunSide CurrentWallRunSide = WallRunSide::NONE;
 	FVector CurrentWallRunDirection = FVector::ZeroVector;
 
+	// owning client decides wall runs, server and other clients only need to know one is going on
+	UPROPERTY(Replicated)
+	bool bNetWallRunning = false;
+
+	UFUNCTION(Server, Reliable)
+	void ServerSetWallRunning(bool bNewWallRunning);
+	void SetNetWallRunning(bool bNewWallRunning);
+
+	// projectiles exist on the server and replicate, the muzzle is where the owning client sees it
+	UFUNCTION(Server, Reliable)
+	void ServerFire(FVector_NetQuantize SpawnLocation, FRotator SpawnRotation);
+	void SpawnProjectile(const FVector& SpawnLocation, const FRotator& SpawnRotation);
+
+	// start times for telemetry durations
+	float WallRunStartTime = 0.0f;
+	float BoostStartTime = 0.0f;
+
 	// boost status
 	bool bIsBoost = false;
 	float boostSpeed = 0.0f;
 	float standartSpeed = 0.0f;
 
 	// checkpoint
-	FVector checpoint = FVector::ZeroVector;
-	FRotator startRatate = FRotator::ZeroRotator;
+	FWallRunSnapshot CheckpointSnapshot;
+
+	// recorded history for rewind
+	static constexpr int32 SnapshotCapacity = 600;
+	TWallRunSnapshotRing<FWallRunSnapshot, SnapshotCapacity> SnapshotHistory;
+	float SnapshotAccumulator = 0.0f;
 	
+	// fixed step wall run, step time is 0 when stepping once per frame
+	float WallRunStepTime = 0.0f;
+	float WallRunStepAccumulator = 0.0f;
+	float WallRunStepElapsed = 0.0f;
+	FVector WallRunStepPrevious = FVector::ZeroVector;
+	FVector WallRunStepCurrent = FVector::ZeroVector;
+	FVector WallRunStepTarget = FVector::ZeroVector;
+
 	// wallrun timer
-	FTimerHandle WallRunTimer;
+	FWallRunTimerHandle WallRunTimer;
 	// wallrun timer for some rest
-	FTimerHandle WallRunReloadTimer;
-	// camera tilt timeline
-	FTimeline CameraTiltTimeline;
+	FWallRunTimerHandle WallRunReloadTimer;
 };
\ No newline at end of file
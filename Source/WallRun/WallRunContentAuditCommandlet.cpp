@@ -0,0 +1,235 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WallRunContentAuditCommandlet.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "HAL/FileManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunContentAudit, Log, All);
+
+namespace
+{
+	const TCHAR* ContentAuditSection = TEXT("WallRun.ContentAudit");
+
+	enum class EContentUsage : uint8
+	{
+		Unused = 0,
+		Optional,
+		Required
+	};
+
+	const TCHAR* GetUsageName(EContentUsage Usage)
+	{
+		switch (Usage)
+		{
+		case EContentUsage::Required: return TEXT("Required");
+		case EContentUsage::Optional: return TEXT("Optional");
+		default: return TEXT("Unused");
+		}
+	}
+
+	bool IsGamePackage(FName PackageName)
+	{
+		return PackageName.ToString().StartsWith(TEXT("/Game/"));
+	}
+
+	// marks everything hard reachable from Roots, soft references are collected for the next pass
+	void MarkReachable(IAssetRegistry& AssetRegistry, TArray<FName> Roots, EContentUsage Usage,
+		TMap<FName, EContentUsage>& Usages, TArray<FName>& OutSoftReferences)
+	{
+		while (Roots.Num() > 0)
+		{
+			const FName PackageName = Roots.Pop(false);
+			EContentUsage& PackageUsage = Usages.FindOrAdd(PackageName, EContentUsage::Unused);
+			if (PackageUsage >= Usage)
+			{
+				continue;
+			}
+			PackageUsage = Usage;
+
+			TArray<FName> Dependencies;
+			AssetRegistry.GetDependencies(PackageName, Dependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+			for (FName Dependency : Dependencies)
+			{
+				if (IsGamePackage(Dependency))
+				{
+					Roots.Add(Dependency);
+				}
+			}
+
+			Dependencies.Reset();
+			AssetRegistry.GetDependencies(PackageName, Dependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Soft);
+			for (FName Dependency : Dependencies)
+			{
+				if (IsGamePackage(Dependency))
+				{
+					OutSoftReferences.Add(Dependency);
+				}
+			}
+		}
+	}
+
+	int64 GetPackageSize(FName PackageName)
+	{
+		FString FileName;
+		if (!FPackageName::DoesPackageExist(PackageName.ToString(), &FileName))
+		{
+			return 0;
+		}
+
+		// editor packages may keep bulk data next to the header
+		int64 Size = FMath::Max<int64>(IFileManager::Get().FileSize(*FileName), 0);
+		Size += FMath::Max<int64>(IFileManager::Get().FileSize(*FPaths::ChangeExtension(FileName, TEXT("uexp"))), 0);
+		Size += FMath::Max<int64>(IFileManager::Get().FileSize(*FPaths::ChangeExtension(FileName, TEXT("ubulk"))), 0);
+		return Size;
+	}
+}
+
+int32 UWallRunContentAuditCommandlet::Main(const FString& Params)
+{
+	FString OutDir = FPaths::ProjectSavedDir() / TEXT("ContentAudit");
+	FParse::Value(*Params, TEXT("Out="), OutDir);
+
+	TArray<FString> RootNames;
+	GConfig->GetArray(ContentAuditSection, TEXT("Roots"), RootNames, GGameIni);
+	int32 OptionalChunkId = 1;
+	GConfig->GetInt(ContentAuditSection, TEXT("OptionalChunkId"), OptionalChunkId, GGameIni);
+
+	if (RootNames.Num() == 0)
+	{
+		UE_LOG(LogWallRunContentAudit, Error, TEXT("No roots in [%s] of DefaultGame.ini"), ContentAuditSection);
+		return 1;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FAssetData> GameAssets;
+	AssetRegistry.GetAssetsByPath(TEXT("/Game"), GameAssets, true);
+
+	TMap<FName, EContentUsage> Usages;
+	for (const FAssetData& Asset : GameAssets)
+	{
+		Usages.Add(Asset.PackageName, EContentUsage::Unused);
+	}
+
+	TArray<FName> Roots;
+	for (const FString& RootName : RootNames)
+	{
+		if (!Usages.Contains(*RootName))
+		{
+			UE_LOG(LogWallRunContentAudit, Warning, TEXT("Root %s is not a package in /Game"), *RootName);
+		}
+		Roots.Add(*RootName);
+	}
+
+	// hard references from the roots must be in the base chunk
+	TArray<FName> SoftReferences;
+	MarkReachable(AssetRegistry, Roots, EContentUsage::Required, Usages, SoftReferences);
+
+	// soft references are loaded on demand and can go to an optional chunk
+	while (SoftReferences.Num() > 0)
+	{
+		TArray<FName> NextSoftReferences;
+		MarkReachable(AssetRegistry, MoveTemp(SoftReferences), EContentUsage::Optional, Usages, NextSoftReferences);
+		SoftReferences = MoveTemp(NextSoftReferences);
+	}
+
+	int64 TotalSizes[3] = { 0, 0, 0 };
+	int32 TotalCounts[3] = { 0, 0, 0 };
+	TSet<FString> UsedDirectories;
+
+	FString Csv = TEXT("Package,Usage,SizeBytes\n");
+	Usages.KeySort(FNameLexicalLess());
+	for (const TPair<FName, EContentUsage>& Pair : Usages)
+	{
+		const int64 Size = GetPackageSize(Pair.Key);
+		TotalSizes[(int32)Pair.Value] += Size;
+		++TotalCounts[(int32)Pair.Value];
+		Csv += FString::Printf(TEXT("%s,%s,%lld\n"), *Pair.Key.ToString(), GetUsageName(Pair.Value), Size);
+
+		if (Pair.Value != EContentUsage::Unused)
+		{
+			for (FString Directory = FPackageName::GetLongPackagePath(Pair.Key.ToString()); Directory.Len() > 1; Directory = FPaths::GetPath(Directory))
+			{
+				UsedDirectories.Add(Directory);
+			}
+		}
+	}
+
+	// topmost directories with nothing used under them can be left out of the cook entirely
+	TSet<FString> NeverCookDirectories;
+	for (const TPair<FName, EContentUsage>& Pair : Usages)
+	{
+		if (Pair.Value != EContentUsage::Unused)
+		{
+			continue;
+		}
+
+		FString UnusedDirectory;
+		for (FString Directory = FPackageName::GetLongPackagePath(Pair.Key.ToString()); Directory.Len() > 1 && !UsedDirectories.Contains(Directory); Directory = FPaths::GetPath(Directory))
+		{
+			UnusedDirectory = Directory;
+		}
+
+		if (!UnusedDirectory.IsEmpty())
+		{
+			NeverCookDirectories.Add(UnusedDirectory);
+		}
+	}
+	NeverCookDirectories.Sort(TLess<FString>());
+
+	FString Rules = TEXT("; generated by -run=WallRunContentAudit, merge into DefaultGame.ini\n");
+	Rules += TEXT("[/Script/UnrealEd.ProjectPackagingSettings]\n");
+	for (const FString& Directory : NeverCookDirectories)
+	{
+		Rules += FString::Printf(TEXT("+DirectoriesToNeverCook=(Path=\"%s\")\n"), *Directory);
+	}
+
+	Rules += TEXT("\n[/Script/Engine.AssetManagerSettings]\n");
+	int32 NumOptionalWithoutRule = 0;
+	for (const FAssetData& Asset : GameAssets)
+	{
+		if (Usages.FindRef(Asset.PackageName) != EContentUsage::Optional)
+		{
+			continue;
+		}
+
+		// chunk rules are set per primary asset, the rest follows its references
+		const FPrimaryAssetId PrimaryAssetId = Asset.GetPrimaryAssetId();
+		if (PrimaryAssetId.IsValid())
+		{
+			Rules += FString::Printf(TEXT("+PrimaryAssetRules=(PrimaryAssetId=\"%s\",Rules=(ChunkId=%d,CookRule=AlwaysCook))\n"), *PrimaryAssetId.ToString(), OptionalChunkId);
+		}
+		else
+		{
+			++NumOptionalWithoutRule;
+		}
+	}
+
+	const FString CsvPath = OutDir / TEXT("ContentAudit.csv");
+	const FString RulesPath = OutDir / TEXT("ChunkRules.ini");
+	if (!FFileHelper::SaveStringToFile(Csv, *CsvPath) || !FFileHelper::SaveStringToFile(Rules, *RulesPath))
+	{
+		UE_LOG(LogWallRunContentAudit, Error, TEXT("Can't write results to %s"), *OutDir);
+		return 1;
+	}
+
+	for (EContentUsage Usage : { EContentUsage::Required, EContentUsage::Optional, EContentUsage::Unused })
+	{
+		UE_LOG(LogWallRunContentAudit, Display, TEXT("%s: %d packages, %.2f MB"),
+			GetUsageName(Usage), TotalCounts[(int32)Usage], TotalSizes[(int32)Usage] / (1024.0 * 1024.0));
+	}
+	if (NumOptionalWithoutRule > 0)
+	{
+		UE_LOG(LogWallRunContentAudit, Warning, TEXT("%d optional packages are not primary assets and follow the chunk of their referencer"), NumOptionalWithoutRule);
+	}
+	UE_LOG(LogWallRunContentAudit, Display, TEXT("%d never cook directories, report in %s, rules in %s"), NeverCookDirectories.Num(), *CsvPath, *RulesPath);
+
+	return 0;
+}
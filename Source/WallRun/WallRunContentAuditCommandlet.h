@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "WallRunContentAuditCommandlet.generated.h"
+
+/**
+ * Walks package references from the roots in [WallRun.ContentAudit] and sorts /Game content into
+ * required (hard references), optional (only reachable through soft references) and unused.
+ * Usage: -run=WallRunContentAudit [Out=<directory>]
+ * Writes ContentAudit.csv with package sizes and ChunkRules.ini with cook and chunk rules
+ * to merge into DefaultGame.ini, by default to Saved/ContentAudit.
+ */
+UCLASS()
+class UWallRunContentAuditCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	virtual int32 Main(const FString& Params) override;
+};
@@ -3,6 +3,9 @@
 #include "WallRunGameMode.h"
 #include "WallRunHUD.h"
 #include "WallRunCharacter.h"
+#include "WallRunReplaySubsystem.h"
+#include "WallRunMemory.h"
+#include "Engine/GameInstance.h"
 #include "UObject/ConstructorHelpers.h"
 
 AWallRunGameMode::AWallRunGameMode()
@@ -15,3 +18,22 @@ AWallRunGameMode::AWallRunGameMode()
 	// use our custom HUD class
 	HUDClass = AWallRunHUD::StaticClass();
 }
+
+void AWallRunGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	// replay of the whole session
+	if (UWallRunReplaySubsystem* Replay = GetGameInstance()->GetSubsystem<UWallRunReplaySubsystem>())
+	{
+		Replay->StartSessionRecording();
+	}
+}
+
+APawn* AWallRunGameMode::SpawnDefaultPawnFor_Implementation(AController* NewPlayer, AActor* StartSpot)
+{
+	// character with its components and snapshot ring counts against the character budget
+	LLM_SCOPE_BYTAG(WallRunCharacter);
+
+	return Super::SpawnDefaultPawnFor_Implementation(NewPlayer, StartSpot);
+}
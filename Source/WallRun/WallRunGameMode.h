@@ -13,6 +13,9 @@ class AWallRunGameMode : public AGameModeBase
 
 public:
 	AWallRunGameMode();
+
+	virtual void StartPlay() override;
+	virtual APawn* SpawnDefaultPawnFor_Implementation(AController* NewPlayer, AActor* StartSpot) override;
 };
 
 
@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WallRunGhostManager.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "UObject/ConstructorHelpers.h"
+
+// Sets default values
+AWallRunGhostManager::AWallRunGhostManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	GhostMeshes = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("Ghost meshes"));
+	RootComponent = GhostMeshes;
+	GhostMeshes->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	GhostMeshes->SetCastShadow(false);
+	GhostMeshes->SetMobility(EComponentMobility::Movable);
+	// 0 - not wall running, 1 - right, 2 - left, for the ghost material
+	GhostMeshes->NumCustomDataFloats = 1;
+
+	// capsule with pivot at the bottom, like the character capsule moved by MeshOffset
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> GhostMesh(TEXT("/Game/StarterContent/Shapes/Shape_NarrowCapsule"));
+	if (GhostMesh.Succeeded())
+	{
+		GhostMeshes->SetStaticMesh(GhostMesh.Object);
+	}
+}
+
+void AWallRunGhostManager::RestartRace(const FString& RunName)
+{
+	Ghosts.Reset();
+	GhostMeshes->ClearInstances();
+	PlaybackTime = 0.0f;
+
+	const FString Directory = FPaths::ProjectSavedDir() / GhostDirectory;
+	TArray<FString> GhostFiles;
+	IFileManager::Get().FindFiles(GhostFiles, *(Directory / FString::Printf(TEXT("%s_*.wrg"), *RunName)), true, false);
+
+	// names end with the recording date, newest first
+	GhostFiles.Sort([](const FString& A, const FString& B) { return A > B; });
+	if (GhostFiles.Num() > MaxGhosts)
+	{
+		GhostFiles.SetNum(MaxGhosts);
+	}
+
+	for (const FString& File : GhostFiles)
+	{
+		TUniquePtr<FGhost> Ghost = MakeUnique<FGhost>();
+		if (!Ghost->Reader.Open(Directory / File) || !Ghost->Reader.ReadSample(Ghost->Next))
+		{
+			continue;
+		}
+
+		Ghost->Previous = Ghost->Next;
+		Ghost->SampleInterval = 1.0f / Ghost->Reader.GetHeader().SampleRate;
+		Ghosts.Add(MoveTemp(Ghost));
+	}
+
+	// instances first so custom data has its slots, then the same update as every tick
+	InstanceTransforms.Init(FTransform::Identity, Ghosts.Num());
+	GhostMeshes->AddInstances(InstanceTransforms, false, true);
+	UpdateInstances();
+}
+
+void AWallRunGhostManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Ghosts.Num() == 0)
+	{
+		return;
+	}
+
+	PlaybackTime += DeltaTime;
+
+	StreamSamples();
+	UpdateInstances();
+}
+
+void AWallRunGhostManager::StreamSamples()
+{
+	// only the two samples around playback time are kept per ghost
+	for (const TUniquePtr<FGhost>& Ghost : Ghosts)
+	{
+		while (!Ghost->bFinished && Ghost->NextTime < PlaybackTime)
+		{
+			Ghost->Previous = Ghost->Next;
+			if (Ghost->Reader.ReadSample(Ghost->Next))
+			{
+				Ghost->NextTime += Ghost->SampleInterval;
+			}
+			else
+			{
+				Ghost->bFinished = true;
+			}
+		}
+	}
+}
+
+void AWallRunGhostManager::UpdateInstances()
+{
+	for (int32 Index = 0; Index < Ghosts.Num(); ++Index)
+	{
+		const FGhost& Ghost = *Ghosts[Index];
+		const float PositionScale = Ghost.Reader.GetHeader().PositionScale;
+
+		if (Ghost.bFinished)
+		{
+			// finished ghosts stay at the end point, hidden
+			InstanceTransforms[Index] = FTransform(FQuat::Identity, Ghost.Next.GetLocation(PositionScale) + MeshOffset, FVector::ZeroVector);
+			continue;
+		}
+
+		const float Alpha = FMath::Clamp(1.0f - (Ghost.NextTime - PlaybackTime) / Ghost.SampleInterval, 0.0f, 1.0f);
+		const FVector Location = FMath::Lerp(Ghost.Previous.GetLocation(PositionScale), Ghost.Next.GetLocation(PositionScale), Alpha);
+		const float Yaw = Ghost.Previous.GetYaw() + FMath::FindDeltaAngleDegrees(Ghost.Previous.GetYaw(), Ghost.Next.GetYaw()) * Alpha;
+
+		InstanceTransforms[Index] = FTransform(FRotator(0.0f, Yaw, 0.0f), Location + MeshOffset);
+
+		// written in place, sent together with transforms below
+		GhostMeshes->PerInstanceSMCustomData[Index * GhostMeshes->NumCustomDataFloats] = (float)Ghost.Next.Side;
+	}
+
+	// one batch for all transforms, render state is marked dirty once for them and the custom data
+	GhostMeshes->BatchUpdateInstancesTransforms(0, InstanceTransforms, true, true, true);
+}
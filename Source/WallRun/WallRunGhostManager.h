@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "WallRunGhostStream.h"
+#include "WallRunGhostManager.generated.h"
+
+class UInstancedStaticMeshComponent;
+
+/**
+ * Plays recorded runs from Saved/Ghosts as instances of one mesh.
+ * The local player spawns it, a race of runs from the same start begins each time
+ * the player's ghost recorder starts a run.
+ * Files are streamed sample by sample, all ghosts are interpolated in one pass
+ * and sent to the instanced mesh with a single batch update.
+ */
+UCLASS()
+class WALLRUN_API AWallRunGhostManager : public AActor
+{
+	GENERATED_BODY()
+
+protected:
+	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = "Components")
+	UInstancedStaticMeshComponent* GhostMeshes;
+
+	// directory with .wrg files, relative to Saved
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ghost")
+	FString GhostDirectory = TEXT("Ghosts");
+
+	// newest files are raced first
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ghost", meta = (UIMin = 1, ClampMin = 1))
+	int32 MaxGhosts = 100;
+
+	// from recorded actor location (capsule center) to mesh pivot
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ghost")
+	FVector MeshOffset = FVector(0.0f, 0.0f, -96.0f);
+
+public:
+	// Sets default values for this actor's properties
+	AWallRunGhostManager();
+
+	virtual void Tick(float DeltaTime) override;
+
+	// race the newest runs recorded from the same start, see UWallRunGhostRecorderComponent
+	UFUNCTION(BlueprintCallable, Category = "Ghost")
+	void RestartRace(const FString& RunName);
+
+private:
+	struct FGhost
+	{
+		FWallRunGhostReader Reader;
+		FWallRunGhostSample Previous;
+		FWallRunGhostSample Next;
+		float SampleInterval = 0.0f;
+		float NextTime = 0.0f;
+		bool bFinished = false;
+	};
+
+	void StreamSamples();
+	void UpdateInstances();
+
+	TArray<TUniquePtr<FGhost>> Ghosts;
+	TArray<FTransform> InstanceTransforms;
+	float PlaybackTime = 0.0f;
+};
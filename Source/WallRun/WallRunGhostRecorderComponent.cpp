@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WallRunGhostRecorderComponent.h"
+#include "WallRunCharacter.h"
+#include "WallRunGhostManager.h"
+#include "EngineUtils.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<int32> CVarGhostRecord(
+	TEXT("WallRun.Ghost.Record"),
+	0,
+	TEXT("Record completed player runs to Saved/Ghosts for ghost races"));
+
+UWallRunGhostRecorderComponent::UWallRunGhostRecorderComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+bool UWallRunGhostRecorderComponent::IsOwnerLocallyControlled() const
+{
+	const APawn* Pawn = Cast<APawn>(GetOwner());
+	return Pawn != nullptr && Pawn->IsLocallyControlled();
+}
+
+void UWallRunGhostRecorderComponent::StartRun(const FString& InRunName)
+{
+	if (!IsOwnerLocallyControlled())
+	{
+		return;
+	}
+
+	StopRecording(false);
+	RunName = InRunName;
+
+	// ghosts of earlier runs from the same start
+	for (TActorIterator<AWallRunGhostManager> It(GetWorld()); It; ++It)
+	{
+		It->RestartRace(RunName);
+	}
+
+	if (CVarGhostRecord.GetValueOnGameThread() == 0)
+	{
+		return;
+	}
+
+	const FString Directory = FPaths::ProjectSavedDir() / TEXT("Ghosts");
+	FilePath = Directory / FString::Printf(TEXT("%s_%s.wrg"), *RunName, *FDateTime::Now().ToString(TEXT("%Y.%m.%d-%H.%M.%S")));
+	PartialFilePath = FPaths::ChangeExtension(FilePath, TEXT("part"));
+	File = IFileManager::Get().CreateFileWriter(*PartialFilePath);
+	if (File == nullptr)
+	{
+		return;
+	}
+
+	FWallRunGhostFileHeader Header;
+	Header.SampleRate = SampleRate;
+	Writer = MakeUnique<FWallRunGhostWriter>(Header);
+
+	AddSample();
+	SetComponentTickEnabled(true);
+}
+
+void UWallRunGhostRecorderComponent::RestartRun()
+{
+	if (!RunName.IsEmpty())
+	{
+		StartRun(RunName);
+	}
+}
+
+void UWallRunGhostRecorderComponent::CompleteRun()
+{
+	if (File != nullptr)
+	{
+		// end point of the run
+		AddSample();
+	}
+	StopRecording(true);
+}
+
+void UWallRunGhostRecorderComponent::CancelRun()
+{
+	StopRecording(false);
+}
+
+void UWallRunGhostRecorderComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopRecording(false);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UWallRunGhostRecorderComponent::StopRecording(bool bKeepFile)
+{
+	SetComponentTickEnabled(false);
+
+	if (File != nullptr)
+	{
+		FlushToDisk();
+		File->Close();
+		delete File;
+		File = nullptr;
+
+		if (bKeepFile && IFileManager::Get().Move(*FilePath, *PartialFilePath))
+		{
+			PruneRuns();
+		}
+		else
+		{
+			IFileManager::Get().Delete(*PartialFilePath);
+		}
+	}
+	Writer.Reset();
+	SampleAccumulator = 0.0f;
+}
+
+void UWallRunGhostRecorderComponent::PruneRuns() const
+{
+	const FString Directory = FPaths::GetPath(FilePath);
+	TArray<FString> RunFiles;
+	IFileManager::Get().FindFiles(RunFiles, *(Directory / FString::Printf(TEXT("%s_*.wrg"), *RunName)), true, false);
+
+	// names end with the recording date, oldest first
+	RunFiles.Sort();
+	for (int32 Index = 0; Index < RunFiles.Num() - MaxFilesPerRun; ++Index)
+	{
+		IFileManager::Get().Delete(*(Directory / RunFiles[Index]));
+	}
+}
+
+void UWallRunGhostRecorderComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// fixed rate, several samples on a long frame
+	const float SampleInterval = 1.0f / SampleRate;
+	SampleAccumulator += DeltaTime;
+	while (SampleAccumulator >= SampleInterval)
+	{
+		SampleAccumulator -= SampleInterval;
+		AddSample();
+	}
+
+	if (Writer->GetNumPendingBytes() >= FlushBytes)
+	{
+		FlushToDisk();
+	}
+}
+
+void UWallRunGhostRecorderComponent::AddSample()
+{
+	const AWallRunCharacter* Character = Cast<AWallRunCharacter>(GetOwner());
+	const WallRunMath::ESide Side = Character != nullptr && Character->IsWallRunning() ? ToMathSide(Character->GetWallRunSide()) : WallRunMath::ESide::None;
+
+	FRotator Rotation = GetOwner()->GetActorRotation();
+	if (const APawn* Pawn = Cast<APawn>(GetOwner()))
+	{
+		Rotation.Pitch = Pawn->GetControlRotation().Pitch;
+	}
+
+	Writer->AddSample(FWallRunGhostSample::Quantize(GetOwner()->GetActorLocation(), Rotation, Side, Writer->GetHeader().PositionScale));
+}
+
+void UWallRunGhostRecorderComponent::FlushToDisk()
+{
+	Writer->WriteTo(*File);
+}
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "WallRunGhostStream.h"
+#include "WallRunGhostRecorderComponent.generated.h"
+
+class FArchive;
+
+/**
+ * Records owner character as ghost files in Saved/Ghosts, one file per run
+ * between two checkpoints, so races start from the same place.
+ * Samples at fixed rate and writes encoded data in chunks, only completed
+ * runs are kept and the oldest ones are deleted.
+ */
+UCLASS(ClassGroup = (WallRun), meta = (BlueprintSpawnableComponent))
+class UWallRunGhostRecorderComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UWallRunGhostRecorderComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// drop the current run and start a new one from here, also restarts the ghost race
+	void StartRun(const FString& InRunName);
+	// start the current run again, after the owner is moved back to its start
+	void RestartRun();
+	// keep the current run as a ghost, the owner reached its end
+	void CompleteRun();
+	// drop the current run, nothing is recorded until the next start
+	void CancelRun();
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ghost", meta = (UIMin = 1.0f, ClampMin = 1.0f))
+	float SampleRate = 30.0f;
+
+	// encoded bytes kept in memory before writing them to disk
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ghost", meta = (UIMin = 256, ClampMin = 256))
+	int32 FlushBytes = 4096;
+
+	// completed runs kept per start point, older ones are deleted
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ghost", meta = (UIMin = 1, ClampMin = 1))
+	int32 MaxFilesPerRun = 100;
+
+private:
+	bool IsOwnerLocallyControlled() const;
+	void AddSample();
+	void FlushToDisk();
+	void StopRecording(bool bKeepFile);
+	void PruneRuns() const;
+
+	TUniquePtr<FWallRunGhostWriter> Writer;
+	FArchive* File = nullptr;
+	float SampleAccumulator = 0.0f;
+	// map and start point, prefix of the ghost file names
+	FString RunName;
+	// run is written here and moved to the .wrg name once completed
+	FString PartialFilePath;
+	FString FilePath;
+};
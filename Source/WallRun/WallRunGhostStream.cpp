@@ -0,0 +1,192 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WallRunGhostStream.h"
+#include "HAL/FileManager.h"
+#include "Serialization/Archive.h"
+
+namespace
+{
+	uint32 ZigZagEncode(int32 Value)
+	{
+		return (uint32(Value) << 1) ^ uint32(Value >> 31);
+	}
+
+	int32 ZigZagDecode(uint32 Value)
+	{
+		return int32(Value >> 1) ^ -int32(Value & 1);
+	}
+
+	void WriteVarInt(TArray<uint8>& Bytes, uint32 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Bytes.Add(uint8(Value) | 0x80);
+			Value >>= 7;
+		}
+		Bytes.Add(uint8(Value));
+	}
+
+	uint16 QuantizeAngle(float Degrees)
+	{
+		return uint16(FMath::RoundToInt(FRotator::ClampAxis(Degrees) * (65536.0f / 360.0f)) & 0xFFFF);
+	}
+}
+
+FWallRunGhostSample FWallRunGhostSample::Quantize(const FVector& Location, const FRotator& Rotation, WallRunMath::ESide Side, float PositionScale)
+{
+	FWallRunGhostSample Sample;
+	Sample.Position[0] = (int32)FMath::RoundToInt(Location.X * PositionScale);
+	Sample.Position[1] = (int32)FMath::RoundToInt(Location.Y * PositionScale);
+	Sample.Position[2] = (int32)FMath::RoundToInt(Location.Z * PositionScale);
+	Sample.Yaw = QuantizeAngle(Rotation.Yaw);
+	Sample.Pitch = QuantizeAngle(Rotation.Pitch);
+	Sample.Side = Side;
+	return Sample;
+}
+
+FVector FWallRunGhostSample::GetLocation(float PositionScale) const
+{
+	return FVector(Position[0], Position[1], Position[2]) / PositionScale;
+}
+
+FWallRunGhostWriter::FWallRunGhostWriter(const FWallRunGhostFileHeader& InHeader)
+	: Header(InHeader)
+{
+	Bytes.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+}
+
+void FWallRunGhostWriter::AddSample(const FWallRunGhostSample& Sample)
+{
+	const bool bKeyframe = NumSamples % Header.KeyframeInterval == 0;
+	const FWallRunGhostSample Base = bKeyframe ? FWallRunGhostSample() : Previous;
+
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		WriteVarInt(Bytes, ZigZagEncode(Sample.Position[Axis] - Base.Position[Axis]));
+	}
+	// angles wrap around, shortest 16 bit delta
+	WriteVarInt(Bytes, ZigZagEncode(int16(uint16(Sample.Yaw - Base.Yaw))));
+	WriteVarInt(Bytes, ZigZagEncode(int16(uint16(Sample.Pitch - Base.Pitch))));
+	Bytes.Add(uint8(Sample.Side));
+
+	Previous = Sample;
+	++NumSamples;
+}
+
+void FWallRunGhostWriter::WriteTo(FArchive& Ar)
+{
+	Ar.Serialize(Bytes.GetData(), Bytes.Num());
+	Bytes.Reset();
+}
+
+FWallRunGhostReader::~FWallRunGhostReader()
+{
+	delete Reader;
+}
+
+bool FWallRunGhostReader::Open(const FString& FilePath)
+{
+	delete Reader;
+	Reader = IFileManager::Get().CreateFileReader(*FilePath);
+	if (Reader == nullptr || Reader->TotalSize() < (int64)sizeof(Header))
+	{
+		delete Reader;
+		Reader = nullptr;
+		return false;
+	}
+
+	Reader->Serialize(&Header, sizeof(Header));
+	if (Header.Magic != FWallRunGhostFileHeader::ExpectedMagic
+		|| Header.Version != FWallRunGhostFileHeader::CurrentVersion
+		|| Header.SampleRate <= 0.0f || Header.PositionScale <= 0.0f || Header.KeyframeInterval == 0)
+	{
+		delete Reader;
+		Reader = nullptr;
+		return false;
+	}
+
+	Previous = FWallRunGhostSample();
+	NumSamples = 0;
+	ChunkNum = 0;
+	ChunkPos = 0;
+	return true;
+}
+
+bool FWallRunGhostReader::ReadSample(FWallRunGhostSample& OutSample)
+{
+	if (Reader == nullptr)
+	{
+		return false;
+	}
+
+	const bool bKeyframe = NumSamples % Header.KeyframeInterval == 0;
+	const FWallRunGhostSample Base = bKeyframe ? FWallRunGhostSample() : Previous;
+
+	uint32 Values[5];
+	for (uint32& Value : Values)
+	{
+		if (!ReadVarInt(Value))
+		{
+			return false;
+		}
+	}
+
+	uint8 Side = 0;
+	if (!ReadByte(Side))
+	{
+		return false;
+	}
+
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		OutSample.Position[Axis] = Base.Position[Axis] + ZigZagDecode(Values[Axis]);
+	}
+	OutSample.Yaw = uint16(Base.Yaw + ZigZagDecode(Values[3]));
+	OutSample.Pitch = uint16(Base.Pitch + ZigZagDecode(Values[4]));
+	OutSample.Side = (WallRunMath::ESide)Side;
+
+	Previous = OutSample;
+	++NumSamples;
+	return true;
+}
+
+bool FWallRunGhostReader::ReadByte(uint8& OutByte)
+{
+	if (ChunkPos == ChunkNum)
+	{
+		const int64 Remaining = Reader->TotalSize() - Reader->Tell();
+		ChunkNum = (int32)FMath::Min<int64>(Remaining, ChunkSize);
+		ChunkPos = 0;
+		if (ChunkNum <= 0)
+		{
+			return false;
+		}
+		Reader->Serialize(Chunk, ChunkNum);
+	}
+
+	OutByte = Chunk[ChunkPos++];
+	return true;
+}
+
+bool FWallRunGhostReader::ReadVarInt(uint32& OutValue)
+{
+	OutValue = 0;
+	for (int32 Shift = 0; Shift < 35; Shift += 7)
+	{
+		uint8 Byte = 0;
+		if (!ReadByte(Byte))
+		{
+			return false;
+		}
+
+		OutValue |= uint32(Byte & 0x7F) << Shift;
+		if ((Byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+
+	// corrupted file
+	return false;
+}
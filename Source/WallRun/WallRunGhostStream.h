@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WallRunMath.h"
+
+class FArchive;
+
+/**
+ * Ghost file format (.wrg):
+ * header, then one sample per 1 / SampleRate seconds.
+ * Position is quantized to 1 / PositionScale cm, yaw and pitch to 1/65536 of a turn.
+ * Every sample is stored as zigzag varint deltas from the previous one,
+ * every KeyframeInterval-th sample is stored as delta from zero so a reader can resync.
+ */
+struct FWallRunGhostFileHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x48475257; // "WRGH"
+	static constexpr uint32 CurrentVersion = 1;
+
+	uint32 Magic = ExpectedMagic;
+	uint32 Version = CurrentVersion;
+	float SampleRate = 30.0f;
+	float PositionScale = 4.0f;
+	uint32 KeyframeInterval = 64;
+};
+
+// one quantized sample of a recorded run
+struct FWallRunGhostSample
+{
+	int32 Position[3] = { 0, 0, 0 };
+	uint16 Yaw = 0;
+	uint16 Pitch = 0;
+	WallRunMath::ESide Side = WallRunMath::ESide::None;
+
+	static FWallRunGhostSample Quantize(const FVector& Location, const FRotator& Rotation, WallRunMath::ESide Side, float PositionScale);
+	FVector GetLocation(float PositionScale) const;
+	float GetYaw() const { return Yaw * (360.0f / 65536.0f); }
+	float GetPitch() const { return Pitch * (360.0f / 65536.0f); }
+};
+
+/** Encodes samples into memory, owner decides when to write the bytes out */
+class FWallRunGhostWriter
+{
+public:
+	explicit FWallRunGhostWriter(const FWallRunGhostFileHeader& InHeader);
+
+	void AddSample(const FWallRunGhostSample& Sample);
+
+	// encoded bytes not written yet, header is included before the first sample
+	int32 GetNumPendingBytes() const { return Bytes.Num(); }
+	void WriteTo(FArchive& Ar);
+
+	const FWallRunGhostFileHeader& GetHeader() const { return Header; }
+
+private:
+	FWallRunGhostFileHeader Header;
+	FWallRunGhostSample Previous;
+	uint32 NumSamples = 0;
+	TArray<uint8> Bytes;
+};
+
+/** Decodes a ghost file while reading it in small chunks */
+class FWallRunGhostReader
+{
+public:
+	~FWallRunGhostReader();
+
+	bool Open(const FString& FilePath);
+	bool ReadSample(FWallRunGhostSample& OutSample);
+
+	const FWallRunGhostFileHeader& GetHeader() const { return Header; }
+
+private:
+	bool ReadByte(uint8& OutByte);
+	bool ReadVarInt(uint32& OutValue);
+
+	static constexpr int32 ChunkSize = 4096;
+
+	FArchive* Reader = nullptr;
+	FWallRunGhostFileHeader Header;
+	FWallRunGhostSample Previous;
+	uint32 NumSamples = 0;
+
+	uint8 Chunk[ChunkSize];
+	int32 ChunkNum = 0;
+	int32 ChunkPos = 0;
+};
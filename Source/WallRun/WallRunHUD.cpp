@@ -6,9 +6,12 @@
 #include "TextureResource.h"
 #include "CanvasItem.h"
 #include "UObject/ConstructorHelpers.h"
+#include "WallRunMemory.h"
 
 AWallRunHUD::AWallRunHUD()
 {
+	LLM_SCOPE_BYTAG(WallRunHUD);
+
 	// Set the crosshair texture
 	static ConstructorHelpers::FObjectFinder<UTexture2D> CrosshairTexObj(TEXT("/Game/FirstPerson/Textures/FirstPersonCrosshair"));
 	CrosshairTex = CrosshairTexObj.Object;
@@ -17,6 +20,8 @@ AWallRunHUD::AWallRunHUD()
 
 void AWallRunHUD::DrawHUD()
 {
+	LLM_SCOPE_BYTAG(WallRunHUD);
+
 	Super::DrawHUD();
 
 	// Draw very simple crosshair
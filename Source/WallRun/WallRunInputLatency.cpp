@@ -0,0 +1,230 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WallRunInputLatency.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Engine/Engine.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/World.h"
+#include "Widgets/SViewport.h"
+#include "GameFramework/InputSettings.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunInputLatency, Log, All);
+
+// move direction change that counts as reaction to move input
+static constexpr float MinMoveDirectionChange = 0.01f;
+// input that changed nothing (key already held, blocked move) is dropped after this
+static constexpr double MaxPendingSeconds = 0.5;
+
+TSharedRef<FWallRunInputLatency> FWallRunInputLatency::GetShared()
+{
+	// slate keeps input processors by shared pointer
+	static TSharedRef<FWallRunInputLatency> Instance = MakeShared<FWallRunInputLatency>();
+	return Instance;
+}
+
+FWallRunInputLatency& FWallRunInputLatency::Get()
+{
+	return GetShared().Get();
+}
+
+void FWallRunInputLatency::Register()
+{
+	FWallRunInputLatency& InputLatency = Get();
+	if (!InputLatency.bRegistered && FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().RegisterInputPreProcessor(GetShared());
+		InputLatency.bRegistered = true;
+		InputLatency.DropPendingInput();
+	}
+}
+
+void FWallRunInputLatency::Unregister()
+{
+	FWallRunInputLatency& InputLatency = Get();
+	if (InputLatency.bRegistered && FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().UnregisterInputPreProcessor(GetShared());
+	}
+	InputLatency.bRegistered = false;
+}
+
+bool FWallRunInputLatency::IsGameInputActive()
+{
+	const UGameViewportClient* GameViewport = GEngine != nullptr ? GEngine->GameViewport : nullptr;
+	const UWorld* World = GameViewport != nullptr ? GameViewport->GetWorld() : nullptr;
+	if (World == nullptr || World->IsPaused())
+	{
+		return false;
+	}
+
+	// menus and editor windows take focus away from the game viewport
+	const TSharedPtr<SViewport> ViewportWidget = GameViewport->GetGameViewportWidget();
+	return ViewportWidget.IsValid() && ViewportWidget->HasAnyUserFocusOrFocusedDescendants();
+}
+
+void FWallRunInputLatency::DropPendingInput()
+{
+	PendingMoveTime = 0.0;
+	PendingLookTime = 0.0;
+}
+
+void FWallRunInputLatency::CacheKeys()
+{
+	if (bKeysCached)
+	{
+		return;
+	}
+	bKeysCached = true;
+
+	const UInputSettings* InputSettings = UInputSettings::GetInputSettings();
+	TArray<FInputAxisKeyMapping> Mappings;
+
+	for (const TCHAR* AxisName : { TEXT("MoveForward"), TEXT("MoveRight") })
+	{
+		InputSettings->GetAxisMappingByName(AxisName, Mappings);
+		for (const FInputAxisKeyMapping& Mapping : Mappings)
+		{
+			MoveKeys.Add(Mapping.Key);
+		}
+	}
+
+	for (const TCHAR* AxisName : { TEXT("TurnRate"), TEXT("LookUpRate") })
+	{
+		InputSettings->GetAxisMappingByName(AxisName, Mappings);
+		for (const FInputAxisKeyMapping& Mapping : Mappings)
+		{
+			LookKeys.Add(Mapping.Key);
+		}
+	}
+}
+
+bool FWallRunInputLatency::HandleKeyDownEvent(FSlateApplication& SlateApp, const FKeyEvent& InKeyEvent)
+{
+	CacheKeys();
+	if (!InKeyEvent.IsRepeat() && MoveKeys.Contains(InKeyEvent.GetKey()))
+	{
+		OnMoveInput();
+	}
+	return false;
+}
+
+bool FWallRunInputLatency::HandleKeyUpEvent(FSlateApplication& SlateApp, const FKeyEvent& InKeyEvent)
+{
+	CacheKeys();
+	if (MoveKeys.Contains(InKeyEvent.GetKey()))
+	{
+		OnMoveInput();
+	}
+	return false;
+}
+
+bool FWallRunInputLatency::HandleAnalogInputEvent(FSlateApplication& SlateApp, const FAnalogInputEvent& InAnalogInputEvent)
+{
+	CacheKeys();
+	if (MoveKeys.Contains(InAnalogInputEvent.GetKey()))
+	{
+		OnMoveInput();
+	}
+	else if (LookKeys.Contains(InAnalogInputEvent.GetKey()))
+	{
+		OnLookInput();
+	}
+	return false;
+}
+
+bool FWallRunInputLatency::HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	if (!MouseEvent.GetCursorDelta().IsZero())
+	{
+		OnLookInput();
+	}
+	return false;
+}
+
+void FWallRunInputLatency::OnMoveInput()
+{
+	if (PendingMoveTime == 0.0 && IsGameInputActive())
+	{
+		PendingMoveTime = FPlatformTime::Seconds();
+	}
+}
+
+void FWallRunInputLatency::OnLookInput()
+{
+	if (PendingLookTime == 0.0 && IsGameInputActive())
+	{
+		PendingLookTime = FPlatformTime::Seconds();
+	}
+}
+
+void FWallRunInputLatency::OnViewComputed(const FVector& LocalMoveDirection, const FRotator& ViewRotation)
+{
+	// input from before a pause or menu would close with its whole duration
+	if (!IsGameInputActive())
+	{
+		DropPendingInput();
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	if (PendingMoveTime != 0.0 && Now - PendingMoveTime > MaxPendingSeconds)
+	{
+		PendingMoveTime = 0.0;
+	}
+	if (PendingLookTime != 0.0 && Now - PendingLookTime > MaxPendingSeconds)
+	{
+		PendingLookTime = 0.0;
+	}
+
+	// pressing or releasing a move key changes the direction, turning with a key held does not
+	const FVector MoveDirection = LocalMoveDirection.GetSafeNormal();
+	if (PendingMoveTime != 0.0 && !MoveDirection.Equals(PreviousMoveDirection, MinMoveDirectionChange))
+	{
+		MoveLatency.Add((Now - PendingMoveTime) * 1000.0);
+		PendingMoveTime = 0.0;
+	}
+
+	// roll is wall run tilt, not look input
+	const FRotator LookRotation(ViewRotation.Pitch, ViewRotation.Yaw, 0.0f);
+	if (PendingLookTime != 0.0 && !LookRotation.Equals(PreviousViewRotation, KINDA_SMALL_NUMBER))
+	{
+		LookLatency.Add((Now - PendingLookTime) * 1000.0);
+		PendingLookTime = 0.0;
+	}
+
+	PreviousMoveDirection = MoveDirection;
+	PreviousViewRotation = LookRotation;
+}
+
+void FWallRunInputLatency::FLatencySamples::Add(float LatencyMs)
+{
+	Samples[Next] = LatencyMs;
+	Next = (Next + 1) % Capacity;
+	Num = FMath::Min(Num + 1, Capacity);
+}
+
+float FWallRunInputLatency::FLatencySamples::GetPercentile(float Percentile) const
+{
+	if (Num == 0)
+	{
+		return 0.0f;
+	}
+
+	TArray<float, TInlineAllocator<Capacity>> Sorted(Samples, Num);
+	Sorted.Sort();
+	return Sorted[FMath::Clamp(FMath::FloorToInt(Percentile * (Num - 1)), 0, Num - 1)];
+}
+
+void FWallRunInputLatency::PrintStats() const
+{
+	UE_LOG(LogWallRunInputLatency, Display, TEXT("Input to movement: %d samples, p50 %.2f ms, p95 %.2f ms, p99 %.2f ms"),
+		MoveLatency.Num, MoveLatency.GetPercentile(0.5f), MoveLatency.GetPercentile(0.95f), MoveLatency.GetPercentile(0.99f));
+	UE_LOG(LogWallRunInputLatency, Display, TEXT("Input to camera: %d samples, p50 %.2f ms, p95 %.2f ms, p99 %.2f ms"),
+		LookLatency.Num, LookLatency.GetPercentile(0.5f), LookLatency.GetPercentile(0.95f), LookLatency.GetPercentile(0.99f));
+}
+
+static FAutoConsoleCommand WallRunInputLatencyCommand(
+	TEXT("WallRun.InputLatency"),
+	TEXT("Print input to motion latency percentiles"),
+	FConsoleCommandDelegate::CreateLambda([]() { FWallRunInputLatency::Get().PrintStats(); }));
@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Framework/Application/IInputProcessor.h"
+
+/**
+ * Measures time from raw input events to the frame where they change
+ * pawn movement input (move input) or view rotation (look input).
+ * Registered by the local player in game worlds, input while the game viewport
+ * has no focus or the game is paused is not measured.
+ */
+class FWallRunInputLatency : public IInputProcessor
+{
+public:
+	static FWallRunInputLatency& Get();
+
+	// both can be called more than once
+	static void Register();
+	static void Unregister();
+
+	// called when the view is computed, last point of the frame that sees final movement input and rotation,
+	// move direction is movement component acceleration in pawn space so gravity and impulses don't count
+	void OnViewComputed(const FVector& LocalMoveDirection, const FRotator& ViewRotation);
+
+	void PrintStats() const;
+
+	// IInputProcessor
+	virtual void Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor) override {}
+	virtual bool HandleKeyDownEvent(FSlateApplication& SlateApp, const FKeyEvent& InKeyEvent) override;
+	virtual bool HandleKeyUpEvent(FSlateApplication& SlateApp, const FKeyEvent& InKeyEvent) override;
+	virtual bool HandleAnalogInputEvent(FSlateApplication& SlateApp, const FAnalogInputEvent& InAnalogInputEvent) override;
+	virtual bool HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	virtual const TCHAR* GetDebugName() const override { return TEXT("WallRunInputLatency"); }
+
+private:
+	static TSharedRef<FWallRunInputLatency> GetShared();
+
+	// last latencies in milliseconds
+	struct FLatencySamples
+	{
+		static constexpr int32 Capacity = 1024;
+
+		float Samples[Capacity];
+		int32 Num = 0;
+		int32 Next = 0;
+
+		void Add(float LatencyMs);
+		float GetPercentile(float Percentile) const;
+	};
+
+	// game viewport has focus and the world is not paused
+	static bool IsGameInputActive();
+	void DropPendingInput();
+
+	void CacheKeys();
+	void OnMoveInput();
+	void OnLookInput();
+
+	TSet<FKey> MoveKeys;
+	TSet<FKey> LookKeys;
+	bool bKeysCached = false;
+	bool bRegistered = false;
+
+	// time of the oldest input event not seen in motion yet, zero when there is none
+	double PendingMoveTime = 0.0;
+	double PendingLookTime = 0.0;
+
+	FVector PreviousMoveDirection = FVector::ZeroVector;
+	FRotator PreviousViewRotation = FRotator::ZeroRotator;
+
+	FLatencySamples MoveLatency;
+	FLatencySamples LookLatency;
+};
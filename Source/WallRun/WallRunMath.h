@@ -0,0 +1,194 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Wall run decisions without any world or actor access.
+ * AWallRunCharacter uses the scalar functions, the batch functions are for
+ * evaluating many candidates (bots, crowds) at once.
+ */
+namespace WallRunMath
+{
+	// wall side relative to the actor, same values as ESide of the character
+	enum class ESide : uint8
+	{
+		None = 0,
+		Right,
+		Left
+	};
+
+	// axis threshold for AreRequaredKeysDown
+	constexpr float KeyThreshold = 0.1f;
+	// walls leaning over the character a little are still runnable
+	constexpr float MinWallNormalZ = -0.005f;
+
+	// side of the wall relative to actor and run direction along it
+	FORCEINLINE void GetESideAndDirection(const FVector& HitNormal, const FVector& ActorRight, ESide& OutSide, FVector& OutDirection)
+	{
+		if (FVector::DotProduct(HitNormal, ActorRight) > 0.0f)
+		{
+			OutSide = ESide::Left;
+			OutDirection = FVector::CrossProduct(HitNormal, FVector::UpVector).GetSafeNormal();
+		}
+		else
+		{
+			OutSide = ESide::Right;
+			OutDirection = FVector::CrossProduct(FVector::UpVector, HitNormal).GetSafeNormal();
+		}
+	}
+
+	FORCEINLINE bool IsSurfaceWallRunable(const FVector& SurfaceNormal, float WalkableFloorZ)
+	{
+		return !(SurfaceNormal.Z > WalkableFloorZ || SurfaceNormal.Z < MinWallNormalZ);
+	}
+
+	FORCEINLINE bool AreRequaredKeysDown(ESide Side, float ForwardAxis, float RightAxis)
+	{
+		if (ForwardAxis < KeyThreshold)
+		{
+			return false;
+		}
+
+		if (Side == ESide::Left && RightAxis > KeyThreshold)
+		{
+			return false;
+		}
+
+		if (Side == ESide::Right && RightAxis < -KeyThreshold)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	// launch velocity for a jump off the wall
+	FORCEINLINE FVector GetWallJumpVelocity(ESide Side, const FVector& WallRunDirection, float JumpZVelocity, bool bIsBoost)
+	{
+		FVector JumpDirrection = Side == ESide::Right
+			? FVector::CrossProduct(WallRunDirection, FVector::UpVector).GetSafeNormal()
+			: FVector::CrossProduct(FVector::UpVector, WallRunDirection).GetSafeNormal();
+
+		JumpDirrection += FVector::UpVector;
+
+		if (bIsBoost)
+		{
+			JumpDirrection += WallRunDirection;
+		}
+
+		return JumpZVelocity * JumpDirrection.GetSafeNormal();
+	}
+
+	/**
+	 * Candidates in structure-of-arrays layout, one entry per hit:
+	 * wall normal, right vector of the actor and its input axes.
+	 * All views must have the same length.
+	 */
+	struct FCandidateBatch
+	{
+		TArrayView<const float> NormalX;
+		TArrayView<const float> NormalY;
+		TArrayView<const float> NormalZ;
+		TArrayView<const float> RightX;
+		TArrayView<const float> RightY;
+		TArrayView<const float> RightZ;
+		TArrayView<const float> ForwardAxis;
+		TArrayView<const float> RightAxis;
+
+		int32 Num() const { return NormalX.Num(); }
+	};
+
+	// results of batch evaluation, wall run direction is always horizontal so Z is not stored
+	struct FResultBatch
+	{
+		TArrayView<ESide> Side;
+		TArrayView<float> DirectionX;
+		TArrayView<float> DirectionY;
+		TArrayView<bool> bCanWallRun;
+	};
+
+	// reference implementation, one candidate at a time
+	inline void EvaluateBatchScalar(const FCandidateBatch& In, const FResultBatch& Out, float WalkableFloorZ)
+	{
+		for (int32 i = 0; i < In.Num(); ++i)
+		{
+			const FVector Normal(In.NormalX[i], In.NormalY[i], In.NormalZ[i]);
+			const FVector Right(In.RightX[i], In.RightY[i], In.RightZ[i]);
+
+			FVector Direction;
+			GetESideAndDirection(Normal, Right, Out.Side[i], Direction);
+
+			Out.DirectionX[i] = (float)Direction.X;
+			Out.DirectionY[i] = (float)Direction.Y;
+			Out.bCanWallRun[i] = IsSurfaceWallRunable(Normal, WalkableFloorZ)
+				&& AreRequaredKeysDown(Out.Side[i], In.ForwardAxis[i], In.RightAxis[i]);
+		}
+	}
+
+	// four candidates per iteration, the tail falls back to the scalar path
+	inline void EvaluateBatchSIMD(const FCandidateBatch& In, const FResultBatch& Out, float WalkableFloorZ)
+	{
+		const int32 Num = In.Num();
+		const int32 NumVectorized = Num & ~3;
+
+		const VectorRegister4Float Zero = GlobalVectorConstants::FloatZero;
+		const VectorRegister4Float One = GlobalVectorConstants::FloatOne;
+		const VectorRegister4Float MinusOne = GlobalVectorConstants::FloatMinusOne;
+		const VectorRegister4Float SafeNormalTolerance = VectorSetFloat1(SMALL_NUMBER);
+		const VectorRegister4Float MaxNormalZ = VectorSetFloat1(WalkableFloorZ);
+		const VectorRegister4Float MinNormalZ = VectorSetFloat1(MinWallNormalZ);
+		const VectorRegister4Float Threshold = VectorSetFloat1(KeyThreshold);
+		const VectorRegister4Float MinusThreshold = VectorSetFloat1(-KeyThreshold);
+
+		for (int32 i = 0; i < NumVectorized; i += 4)
+		{
+			const VectorRegister4Float NX = VectorLoad(&In.NormalX[i]);
+			const VectorRegister4Float NY = VectorLoad(&In.NormalY[i]);
+			const VectorRegister4Float NZ = VectorLoad(&In.NormalZ[i]);
+
+			// side: dot(normal, right) > 0 means wall on the left
+			VectorRegister4Float Dot = VectorMultiply(NX, VectorLoad(&In.RightX[i]));
+			Dot = VectorMultiplyAdd(NY, VectorLoad(&In.RightY[i]), Dot);
+			Dot = VectorMultiplyAdd(NZ, VectorLoad(&In.RightZ[i]), Dot);
+			const VectorRegister4Float LeftMask = VectorCompareGT(Dot, Zero);
+
+			// direction: cross(N, Up) = (NY, -NX) on the left, cross(Up, N) = (-NY, NX) on the right
+			const VectorRegister4Float Sign = VectorSelect(LeftMask, One, MinusOne);
+			const VectorRegister4Float LengthSquared = VectorMultiplyAdd(NX, NX, VectorMultiply(NY, NY));
+			const VectorRegister4Float ValidMask = VectorCompareGE(LengthSquared, SafeNormalTolerance);
+			const VectorRegister4Float Scale = VectorSelect(ValidMask, VectorDivide(Sign, VectorSqrt(VectorSelect(ValidMask, LengthSquared, One))), Zero);
+			VectorStore(VectorMultiply(NY, Scale), &Out.DirectionX[i]);
+			VectorStore(VectorNegate(VectorMultiply(NX, Scale)), &Out.DirectionY[i]);
+
+			// surface and keys
+			const VectorRegister4Float Forward = VectorLoad(&In.ForwardAxis[i]);
+			const VectorRegister4Float RightAxis = VectorLoad(&In.RightAxis[i]);
+			VectorRegister4Float Reject = VectorBitwiseOr(VectorCompareGT(NZ, MaxNormalZ), VectorCompareLT(NZ, MinNormalZ));
+			Reject = VectorBitwiseOr(Reject, VectorCompareLT(Forward, Threshold));
+			Reject = VectorBitwiseOr(Reject, VectorSelect(LeftMask, VectorCompareGT(RightAxis, Threshold), VectorCompareLT(RightAxis, MinusThreshold)));
+
+			const int32 LeftBits = VectorMaskBits(LeftMask);
+			const int32 RejectBits = VectorMaskBits(Reject);
+			for (int32 Lane = 0; Lane < 4; ++Lane)
+			{
+				Out.Side[i + Lane] = (LeftBits & (1 << Lane)) ? ESide::Left : ESide::Right;
+				Out.bCanWallRun[i + Lane] = (RejectBits & (1 << Lane)) == 0;
+			}
+		}
+
+		if (NumVectorized < Num)
+		{
+			const int32 Tail = Num - NumVectorized;
+			const FCandidateBatch TailIn{
+				In.NormalX.Slice(NumVectorized, Tail), In.NormalY.Slice(NumVectorized, Tail), In.NormalZ.Slice(NumVectorized, Tail),
+				In.RightX.Slice(NumVectorized, Tail), In.RightY.Slice(NumVectorized, Tail), In.RightZ.Slice(NumVectorized, Tail),
+				In.ForwardAxis.Slice(NumVectorized, Tail), In.RightAxis.Slice(NumVectorized, Tail) };
+			const FResultBatch TailOut{
+				Out.Side.Slice(NumVectorized, Tail), Out.DirectionX.Slice(NumVectorized, Tail),
+				Out.DirectionY.Slice(NumVectorized, Tail), Out.bCanWallRun.Slice(NumVectorized, Tail) };
+			EvaluateBatchScalar(TailIn, TailOut, WalkableFloorZ);
+		}
+	}
+}
@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WallRunMemory.h"
+#include "WallRunCharacter.h"
+#include "WallRunProjectile.h"
+#include "WallRunHUD.h"
+#include "Checkpoint.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/ConfigCacheIni.h"
+
+LLM_DEFINE_TAG(WallRunCharacter);
+LLM_DEFINE_TAG(WallRunCheckpoint);
+LLM_DEFINE_TAG(WallRunProjectile);
+LLM_DEFINE_TAG(WallRunHUD);
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunMemory, Log, All);
+
+namespace
+{
+	// budgets live in [WallRun.MemoryBudgets] of DefaultGame.ini
+	const TCHAR* MemoryBudgetsSection = TEXT("WallRun.MemoryBudgets");
+
+	int32 GetConfigInt(const TCHAR* Key, int32 DefaultValue)
+	{
+		int32 Value = DefaultValue;
+		GConfig->GetInt(MemoryBudgetsSection, Key, Value, GGameIni);
+		return Value;
+	}
+
+	template<typename ActorType>
+	int32 CountActors(UWorld* World)
+	{
+		int32 Count = 0;
+		for (TActorIterator<ActorType> It(World); It; ++It)
+		{
+			++Count;
+		}
+		return Count;
+	}
+
+	// returns false if tag is over one of its budgets, zero budget means no limit
+	bool CheckTagBudget(const TCHAR* TagName, int32 NumInstances)
+	{
+		const int64 TotalBytes = FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, FName(TagName));
+		const int64 PerInstanceBytes = NumInstances > 0 ? TotalBytes / NumInstances : 0;
+		const int64 TotalBudgetBytes = GetConfigInt(*FString::Printf(TEXT("%sTotalKB"), TagName), 0) * 1024LL;
+		const int64 PerInstanceBudgetBytes = GetConfigInt(*FString::Printf(TEXT("%sPerInstanceKB"), TagName), 0) * 1024LL;
+
+		const bool bTotalOk = TotalBudgetBytes == 0 || TotalBytes <= TotalBudgetBytes;
+		const bool bPerInstanceOk = PerInstanceBudgetBytes == 0 || PerInstanceBytes <= PerInstanceBudgetBytes;
+
+		if (bTotalOk && bPerInstanceOk)
+		{
+			UE_LOG(LogWallRunMemory, Display, TEXT("%s: %d instances, %lld KB total (budget %lld), %lld KB per instance (budget %lld)"),
+				TagName, NumInstances, TotalBytes / 1024, TotalBudgetBytes / 1024, PerInstanceBytes / 1024, PerInstanceBudgetBytes / 1024);
+		}
+		else
+		{
+			UE_LOG(LogWallRunMemory, Error, TEXT("%s over budget: %d instances, %lld KB total (budget %lld), %lld KB per instance (budget %lld)"),
+				TagName, NumInstances, TotalBytes / 1024, TotalBudgetBytes / 1024, PerInstanceBytes / 1024, PerInstanceBudgetBytes / 1024);
+		}
+
+		return bTotalOk && bPerInstanceOk;
+	}
+}
+
+bool WallRunMemory::CheckMemoryBudgets(UWorld* World)
+{
+	bool bPassed = true;
+	bPassed &= CheckTagBudget(TEXT("WallRunCharacter"), CountActors<AWallRunCharacter>(World));
+	bPassed &= CheckTagBudget(TEXT("WallRunCheckpoint"), CountActors<ACheckpoint>(World));
+	bPassed &= CheckTagBudget(TEXT("WallRunProjectile"), CountActors<AWallRunProjectile>(World));
+	bPassed &= CheckTagBudget(TEXT("WallRunHUD"), CountActors<AWallRunHUD>(World));
+	return bPassed;
+}
+
+void WallRunMemory::SpawnBudgetActors(UWorld* World)
+{
+	const APawn* Player = World->GetFirstPlayerController() != nullptr ? World->GetFirstPlayerController()->GetPawn() : nullptr;
+	const FVector Origin = Player != nullptr ? Player->GetActorLocation() : FVector::ZeroVector;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	const int32 NumCheckpoints = GetConfigInt(TEXT("SpawnCheckpoints"), 0);
+	for (int32 Index = 0; Index < NumCheckpoints; ++Index)
+	{
+		LLM_SCOPE_BYTAG(WallRunCheckpoint);
+		World->SpawnActor<ACheckpoint>(Origin + FVector(500.0f * (Index + 1), 0.0f, 0.0f), FRotator::ZeroRotator, SpawnParams);
+	}
+
+	const int32 NumProjectiles = GetConfigInt(TEXT("SpawnProjectiles"), 0);
+	for (int32 Index = 0; Index < NumProjectiles; ++Index)
+	{
+		LLM_SCOPE_BYTAG(WallRunProjectile);
+		World->SpawnActor<AWallRunProjectile>(Origin + FVector(0.0f, 50.0f * Index, 1000.0f), FRotator(90.0f, 0.0f, 0.0f), SpawnParams);
+	}
+}
+
+#endif // ENABLE_LOW_LEVEL_MEM_TRACKER
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+class UWorld;
+
+// Low-Level Memory Tracker tags for WallRun systems, see the WallRun.Memory.Budgets automation test
+LLM_DECLARE_TAG(WallRunCharacter);
+LLM_DECLARE_TAG(WallRunCheckpoint);
+LLM_DECLARE_TAG(WallRunProjectile);
+LLM_DECLARE_TAG(WallRunHUD);
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+
+namespace WallRunMemory
+{
+	// compares LLM totals of WallRun tags with [WallRun.MemoryBudgets], returns false if any is over
+	bool CheckMemoryBudgets(UWorld* World);
+
+	// spawns SpawnCheckpoints and SpawnProjectiles actors from [WallRun.MemoryBudgets] under their tags
+	void SpawnBudgetActors(UWorld* World);
+}
+
+#endif // ENABLE_LOW_LEVEL_MEM_TRACKER
@@ -3,9 +3,13 @@
 #include "WallRunProjectile.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
+#include "WallRunTaskScheduler.h"
+#include "WallRunMemory.h"
 
 AWallRunProjectile::AWallRunProjectile() 
 {
+	LLM_SCOPE_BYTAG(WallRunProjectile);
+
 	// Use a sphere as a simple collision representation
 	CollisionComp = CreateDefaultSubobject<USphereComponent>(TEXT("SphereComp"));
 	CollisionComp->InitSphereRadius(5.0f);
@@ -29,6 +33,10 @@ AWallRunProjectile::AWallRunProjectile()
 
 	// Die after 3 seconds by default
 	InitialLifeSpan = 3.0f;
+
+	// Replicated, relevancy is handled by the replication graph
+	bReplicates = true;
+	SetReplicateMovement(true);
 }
 
 void AWallRunProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
@@ -38,6 +46,17 @@ void AWallRunProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor,
 	{
 		OtherComp->AddImpulseAtLocation(GetVelocity() * 100.0f, GetActorLocation());
 
-		Destroy();
+		// take projectile out of the game now, destroy it when there is time
+		SetActorHiddenInGame(true);
+		SetActorEnableCollision(false);
+		ProjectileMovement->StopMovementImmediately();
+
+		UWallRunTaskScheduler::AddTask(this, EWallRunTaskPriority::Low, [WeakThis = TWeakObjectPtr<AWallRunProjectile>(this)]()
+		{
+			if (AWallRunProjectile* Projectile = WeakThis.Get())
+			{
+				Projectile->Destroy();
+			}
+		});
 	}
 }
\ No newline at end of file
@@ -0,0 +1,227 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WallRunReplaySubsystem.h"
+#include "Engine/DemoNetDriver.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "RenderCore.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunReplay, Log, All);
+
+namespace
+{
+	const TCHAR* MeasureReplayName = TEXT("WallRun_Measure");
+}
+
+void FWallRunReplayFrameStats::Add(double FrameMs)
+{
+	++NumFrames;
+	TotalMs += FrameMs;
+	MaxMs = FMath::Max(MaxMs, FrameMs);
+}
+
+void UWallRunReplaySubsystem::StartSessionRecording()
+{
+	const UWorld* World = GetGameInstance()->GetWorld();
+	if (!bRecordSessions || World == nullptr || World->IsPlayingReplay() || IsRecording())
+	{
+		return;
+	}
+
+	PruneSessionReplays();
+
+	const FString ReplayName = FString::Printf(TEXT("WallRun_%s"), *FDateTime::Now().ToString(TEXT("%Y.%m.%d-%H.%M.%S")));
+	const TArray<FString> Options = { TEXT("ReplayStreamerOverride=LocalFileNetworkReplayStreaming") };
+	GetGameInstance()->StartRecordingReplay(ReplayName, ReplayName, Options);
+
+	UE_LOG(LogWallRunReplay, Log, TEXT("Recording replay %s"), *ReplayName);
+}
+
+void UWallRunReplaySubsystem::PruneSessionReplays() const
+{
+	// local file streamer writes <name>.replay into Saved/Demos
+	const FString Directory = FPaths::ProjectSavedDir() / TEXT("Demos");
+	TArray<FString> ReplayFiles;
+	IFileManager::Get().FindFiles(ReplayFiles, *(Directory / TEXT("WallRun_*.replay")), true, false);
+	ReplayFiles.Remove(FString(MeasureReplayName) + TEXT(".replay"));
+
+	// names end with the recording date, oldest first, room for the one about to start
+	ReplayFiles.Sort();
+	for (int32 Index = 0; Index < ReplayFiles.Num() - FMath::Max(MaxSessionReplays - 1, 0); ++Index)
+	{
+		IFileManager::Get().Delete(*(Directory / ReplayFiles[Index]));
+	}
+}
+
+void UWallRunReplaySubsystem::StopRecording()
+{
+	if (IsRecording())
+	{
+		GetGameInstance()->StopRecordingReplay();
+	}
+}
+
+void UWallRunReplaySubsystem::GotoTime(float TimeInSeconds)
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+	UDemoNetDriver* DemoNetDriver = World != nullptr && World->IsPlayingReplay() ? World->GetDemoNetDriver() : nullptr;
+	if (DemoNetDriver == nullptr)
+	{
+		UE_LOG(LogWallRunReplay, Warning, TEXT("No replay is playing"));
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	DemoNetDriver->GotoTimeInSeconds(TimeInSeconds, FOnGotoTimeDelegate::CreateWeakLambda(this, [TimeInSeconds, StartTime](bool bWasSuccessful)
+	{
+		UE_LOG(LogWallRunReplay, Display, TEXT("Goto %.1f s %s in %.1f ms"),
+			TimeInSeconds, bWasSuccessful ? TEXT("done") : TEXT("failed"), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}));
+}
+
+void UWallRunReplaySubsystem::StartMeasurement(float WindowSeconds, int32 NumWindowPairs)
+{
+	const UWorld* World = GetGameInstance()->GetWorld();
+	if (World == nullptr || World->IsPlayingReplay() || WindowSeconds <= 0.0f || NumWindowPairs <= 0)
+	{
+		return;
+	}
+
+	RecordingFrames = FWallRunReplayFrameStats();
+	IdleFrames = FWallRunReplayFrameStats();
+	MeasureWindowSeconds = WindowSeconds;
+	MeasureWindowsLeft = NumWindowPairs * 2;
+
+	UE_LOG(LogWallRunReplay, Display, TEXT("Measuring replay cost, %d windows of %.1f s, keep playing the same way"), MeasureWindowsLeft, WindowSeconds);
+	BeginMeasurementWindow(false);
+}
+
+void UWallRunReplaySubsystem::BeginMeasurementWindow(bool bRecord)
+{
+	// recording windows overwrite one replay file, they are only for the measurement
+	if (bRecord)
+	{
+		GetGameInstance()->StartRecordingReplay(MeasureReplayName, MeasureReplayName, { TEXT("ReplayStreamerOverride=LocalFileNetworkReplayStreaming") });
+	}
+	else
+	{
+		StopRecording();
+	}
+
+	MeasureWindowTimeLeft = MeasureWindowSeconds;
+	bSkipMeasureFrame = true;
+}
+
+bool UWallRunReplaySubsystem::IsRecording() const
+{
+	const UWorld* World = GetGameInstance()->GetWorld();
+	const UDemoNetDriver* DemoNetDriver = World != nullptr ? World->GetDemoNetDriver() : nullptr;
+	return DemoNetDriver != nullptr && DemoNetDriver->IsRecording();
+}
+
+void UWallRunReplaySubsystem::Tick(float DeltaTime)
+{
+	if (MeasureWindowsLeft == 0)
+	{
+		return;
+	}
+
+	// game thread time of the previous frame, recording is done in world tick,
+	// the frame that started or stopped recording is not steady state
+	if (bSkipMeasureFrame)
+	{
+		bSkipMeasureFrame = false;
+	}
+	else
+	{
+		const double FrameMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+		(IsRecording() ? RecordingFrames : IdleFrames).Add(FrameMs);
+	}
+
+	MeasureWindowTimeLeft -= DeltaTime;
+	if (MeasureWindowTimeLeft > 0.0f)
+	{
+		return;
+	}
+
+	if (--MeasureWindowsLeft > 0)
+	{
+		BeginMeasurementWindow(!IsRecording());
+		return;
+	}
+
+	// last window recorded, session recording goes on in a new file
+	StopRecording();
+	StartSessionRecording();
+	PrintStats();
+}
+
+ETickableTickType UWallRunReplaySubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UWallRunReplaySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWallRunReplaySubsystem, STATGROUP_Tickables);
+}
+
+void UWallRunReplaySubsystem::PrintStats() const
+{
+	UE_LOG(LogWallRunReplay, Display, TEXT("Game thread with recording: %llu frames, avg %.3f ms, max %.3f ms"),
+		RecordingFrames.NumFrames, RecordingFrames.GetAverageMs(), RecordingFrames.MaxMs);
+	UE_LOG(LogWallRunReplay, Display, TEXT("Game thread without recording: %llu frames, avg %.3f ms, max %.3f ms"),
+		IdleFrames.NumFrames, IdleFrames.GetAverageMs(), IdleFrames.MaxMs);
+	UE_LOG(LogWallRunReplay, Display, TEXT("Recording cost: %.3f ms per frame"),
+		RecordingFrames.GetAverageMs() - IdleFrames.GetAverageMs());
+}
+
+namespace
+{
+	UWallRunReplaySubsystem* GetReplaySubsystem(UWorld* World)
+	{
+		UGameInstance* GameInstance = World != nullptr ? World->GetGameInstance() : nullptr;
+		return GameInstance != nullptr ? GameInstance->GetSubsystem<UWallRunReplaySubsystem>() : nullptr;
+	}
+
+	FAutoConsoleCommandWithWorld WallRunReplayStatsCommand(
+		TEXT("WallRun.Replay.Stats"),
+		TEXT("Print game thread frame cost of the last WallRun.Replay.Measure"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (const UWallRunReplaySubsystem* Replay = GetReplaySubsystem(World))
+			{
+				Replay->PrintStats();
+			}
+		}));
+
+	FAutoConsoleCommandWithWorldAndArgs WallRunReplayMeasureCommand(
+		TEXT("WallRun.Replay.Measure"),
+		TEXT("WallRun.Replay.Measure [WindowSeconds=10] [Pairs=3], alternate windows without and with recording during play and compare frame cost"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (UWallRunReplaySubsystem* Replay = GetReplaySubsystem(World))
+			{
+				const float WindowSeconds = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 10.0f;
+				const int32 NumWindowPairs = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 3;
+				Replay->StartMeasurement(WindowSeconds, NumWindowPairs);
+			}
+		}));
+
+	FAutoConsoleCommandWithWorldAndArgs WallRunReplayGotoCommand(
+		TEXT("WallRun.Replay.Goto"),
+		TEXT("WallRun.Replay.Goto <Seconds>, jump to time in the playing replay"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UWallRunReplaySubsystem* Replay = GetReplaySubsystem(World);
+			if (Replay != nullptr && Args.Num() > 0)
+			{
+				Replay->GotoTime(FCString::Atof(*Args[0]));
+			}
+		}));
+}
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "WallRunReplaySubsystem.generated.h"
+
+// game thread cost of frames with and without replay recording
+struct FWallRunReplayFrameStats
+{
+	uint64 NumFrames = 0;
+	double TotalMs = 0.0;
+	double MaxMs = 0.0;
+
+	void Add(double FrameMs);
+	double GetAverageMs() const { return NumFrames > 0 ? TotalMs / NumFrames : 0.0; }
+};
+
+/**
+ * Records whole sessions through the demo net driver into local replay files.
+ * Checkpoints (keyframes) are written every demo.CheckpointUploadDelayInSeconds,
+ * so going to any time loads the nearest one and only simulates the rest.
+ */
+UCLASS(config = Game)
+class UWallRunReplaySubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	// called by the game mode when the match starts
+	void StartSessionRecording();
+	void StopRecording();
+
+	// jump to time of the replay being played, logs how long it took
+	void GotoTime(float TimeInSeconds);
+
+	// alternate equal windows without and with recording during play, then print the cost of both
+	void StartMeasurement(float WindowSeconds, int32 NumWindowPairs);
+
+	void PrintStats() const;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	// record every session played, off unless a build turns it on
+	UPROPERTY(config)
+	bool bRecordSessions = false;
+
+	// session replays kept in Saved/Demos, older ones are deleted when a new recording starts
+	UPROPERTY(config)
+	int32 MaxSessionReplays = 10;
+
+private:
+	void PruneSessionReplays() const;
+	bool IsRecording() const;
+	void BeginMeasurementWindow(bool bRecord);
+
+	FWallRunReplayFrameStats RecordingFrames;
+	FWallRunReplayFrameStats IdleFrames;
+
+	// measurement in progress while windows are left
+	int32 MeasureWindowsLeft = 0;
+	float MeasureWindowSeconds = 0.0f;
+	float MeasureWindowTimeLeft = 0.0f;
+	bool bSkipMeasureFrame = false;
+};
@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WallRunReplicationGraph.h"
+#include "WallRunCharacter.h"
+#include "WallRunProjectile.h"
+#include "Checkpoint.h"
+#include "Engine/LevelScriptActor.h"
+#include "GameFramework/Info.h"
+#include "GameFramework/PlayerController.h"
+
+void UWallRunReplicationGraphNode_Grid::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	const int32 FirstList = Params.OutGatheredReplicationLists.GetLists(EActorRepListTypeFlags::Default).Num();
+
+	Super::GatherActorListsForConnection(Params);
+
+	// only lists added by the grid for this connection, cost is linear in relevant actors
+	const TArray<FActorRepListConstView>& Lists = Params.OutGatheredReplicationLists.GetLists(EActorRepListTypeFlags::Default);
+	for (int32 ListIndex = FirstList; ListIndex < Lists.Num(); ++ListIndex)
+	{
+		for (AActor* Actor : Lists[ListIndex])
+		{
+			APawn* Pawn = Cast<APawn>(Actor);
+			if (Pawn == nullptr)
+			{
+				continue;
+			}
+
+			// distance to the closest viewer of this connection
+			float MinDistanceSquared = TNumericLimits<float>::Max();
+			bool bIsViewTarget = false;
+			for (const FNetViewer& Viewer : Params.Viewers)
+			{
+				bIsViewTarget |= Viewer.ViewTarget == Pawn || Viewer.InViewer == Pawn->GetController();
+				MinDistanceSquared = FMath::Min(MinDistanceSquared, (float)FVector::DistSquared(Viewer.ViewLocation, Pawn->GetActorLocation()));
+			}
+
+			const AWallRunCharacter* Character = Cast<AWallRunCharacter>(Pawn);
+			// replicated from the owning client, the server never runs walls for remote pawns
+			const bool bIsWallRunning = Character != nullptr && Character->IsNetWallRunning();
+
+			uint32 Period = 1;
+			if (!bIsViewTarget && !bIsWallRunning && MinDistanceSquared > NearDistanceSquared)
+			{
+				Period = MinDistanceSquared > MidDistanceSquared ? FarPeriodFrames : MidPeriodFrames;
+			}
+
+			// replication of the connection skips the pawn until FrameNum + Period
+			Params.ConnectionManager.ActorInfoMap.FindOrAdd(Pawn).ReplicationPeriodFrame = Period;
+		}
+	}
+}
+
+void UWallRunReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// projectiles are short lived and only matter close to the viewer
+	FClassReplicationInfo ProjectileInfo;
+	ProjectileInfo.SetCullDistanceSquared(ProjectileCullDistance * ProjectileCullDistance);
+	ProjectileInfo.ReplicationPeriodFrame = 1;
+	GlobalActorReplicationInfoMap.SetClassInfo(AWallRunProjectile::StaticClass(), ProjectileInfo);
+
+	// checkpoints never move, they only wake up once when activated
+	FClassReplicationInfo CheckpointInfo;
+	CheckpointInfo.SetCullDistanceSquared(CheckpointCullDistance * CheckpointCullDistance);
+	GlobalActorReplicationInfoMap.SetClassInfo(ACheckpoint::StaticClass(), CheckpointInfo);
+
+	// grid culls pawns, the grid node buckets them by distance
+	FClassReplicationInfo PawnInfo;
+	PawnInfo.SetCullDistanceSquared(PawnCullDistance * PawnCullDistance);
+	PawnInfo.ReplicationPeriodFrame = 1;
+	GlobalActorReplicationInfoMap.SetClassInfo(APawn::StaticClass(), PawnInfo);
+}
+
+void UWallRunReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UWallRunReplicationGraphNode_Grid>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = FVector2D(SpatialBiasX, SpatialBiasY);
+	GridNode->NearDistanceSquared = PawnNearDistance * PawnNearDistance;
+	GridNode->MidDistanceSquared = PawnMidDistance * PawnMidDistance;
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void UWallRunReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	// player controller and its view target
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantForConnectionNode = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(AlwaysRelevantForConnectionNode, RepGraphConnection);
+}
+
+void UWallRunReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	AActor* Actor = ActorInfo.Actor;
+
+	if (Actor->bOnlyRelevantToOwner)
+	{
+		// player controllers come through AlwaysRelevant_ForConnection
+		return;
+	}
+
+	if (Actor->IsA<APawn>())
+	{
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+	}
+	else if (Actor->IsA<ACheckpoint>())
+	{
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+	}
+	else if (Actor->IsA<AWallRunProjectile>())
+	{
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+	}
+	else if (Actor->bAlwaysRelevant || Actor->IsA<AInfo>() || Actor->IsA<ALevelScriptActor>())
+	{
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+	}
+	else if (Actor->IsRootComponentMovable())
+	{
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+	}
+	else
+	{
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+	}
+}
+
+void UWallRunReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	AActor* Actor = ActorInfo.Actor;
+
+	if (Actor->bOnlyRelevantToOwner)
+	{
+		return;
+	}
+
+	if (Actor->IsA<APawn>())
+	{
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+	}
+	else if (Actor->IsA<ACheckpoint>())
+	{
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+	}
+	else if (Actor->IsA<AWallRunProjectile>())
+	{
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+	}
+	else if (Actor->bAlwaysRelevant || Actor->IsA<AInfo>() || Actor->IsA<ALevelScriptActor>())
+	{
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+	}
+	else if (Actor->IsRootComponentMovable())
+	{
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+	}
+	else
+	{
+		GridNode->RemoveActor_Static(ActorInfo);
+	}
+}
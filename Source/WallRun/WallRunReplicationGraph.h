@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "WallRunReplicationGraph.generated.h"
+
+class UReplicationGraphNode_ActorList;
+class UReplicationGraphNode_AlwaysRelevant_ForConnection;
+
+/**
+ * Spatial grid that also puts pawns it gathered for a connection into distance buckets.
+ * Only pawns in nearby cells are visited, pawn cull distance comes from class info.
+ * Pawns that are wall running or are the viewer's own view target are replicated every frame,
+ * the rest of the near bucket too, mid and far buckets every few frames.
+ */
+UCLASS()
+class UWallRunReplicationGraphNode_Grid : public UReplicationGraphNode_GridSpatialization2D
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	// bucket sizes, squared distance
+	float NearDistanceSquared = 0.0f;
+	float MidDistanceSquared = 0.0f;
+
+	// replicate every N frames in mid and far buckets
+	uint32 MidPeriodFrames = 2;
+	uint32 FarPeriodFrames = 4;
+};
+
+/**
+ * Replication graph for WallRun:
+ * projectiles are in a spatial grid with short cull distance,
+ * checkpoints are static and dormant until activated,
+ * pawns are in the same grid and get per-connection distance buckets there.
+ */
+UCLASS(transient, config = Engine)
+class UWallRunReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+protected:
+	UPROPERTY(config)
+	float GridCellSize = 10000.0f;
+
+	UPROPERTY(config)
+	float SpatialBiasX = -150000.0f;
+
+	UPROPERTY(config)
+	float SpatialBiasY = -200000.0f;
+
+	UPROPERTY(config)
+	float ProjectileCullDistance = 5000.0f;
+
+	UPROPERTY(config)
+	float CheckpointCullDistance = 15000.0f;
+
+	UPROPERTY(config)
+	float PawnNearDistance = 3000.0f;
+
+	UPROPERTY(config)
+	float PawnMidDistance = 8000.0f;
+
+	UPROPERTY(config)
+	float PawnCullDistance = 20000.0f;
+
+	UPROPERTY()
+	UWallRunReplicationGraphNode_Grid* GridNode;
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+};
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+
+/**
+ * Fixed-size ring of snapshots stored inline (no heap allocation).
+ * When full, pushing overwrites the oldest element.
+ */
+template<typename ElementType, int32 Capacity>
+class TWallRunSnapshotRing
+{
+	static_assert(Capacity > 0, "Snapshot ring needs a positive capacity");
+
+public:
+	void Push(const ElementType& Element)
+	{
+		Items[Head] = Element;
+		Head = (Head + 1) % Capacity;
+		Count = FMath::Min(Count + 1, Capacity);
+	}
+
+	// get element by age, 0 is the newest one
+	const ElementType& GetFromNewest(int32 Index) const
+	{
+		check(Index >= 0 && Index < Count);
+		return Items[(Head - 1 - Index + Capacity) % Capacity];
+	}
+
+	// drop newest elements, used after rewind so history continues from the restored one
+	void DiscardNewest(int32 NumToDiscard)
+	{
+		NumToDiscard = FMath::Clamp(NumToDiscard, 0, Count);
+		Head = (Head - NumToDiscard + Capacity) % Capacity;
+		Count -= NumToDiscard;
+	}
+
+	void Reset()
+	{
+		Head = 0;
+		Count = 0;
+	}
+
+	int32 Num() const { return Count; }
+	bool IsEmpty() const { return Count == 0; }
+	static constexpr int32 Max() { return Capacity; }
+
+private:
+	TStaticArray<ElementType, Capacity> Items;
+	int32 Head = 0;
+	int32 Count = 0;
+};
@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WallRunTaskScheduler.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunScheduler, Log, All);
+
+void UWallRunTaskScheduler::AddTask(EWallRunTaskPriority Priority, TFunction<void()>&& Task)
+{
+	Queues[(int32)Priority].Add({ MoveTemp(Task), GFrameCounter });
+}
+
+void UWallRunTaskScheduler::AddTask(const UObject* WorldContextObject, EWallRunTaskPriority Priority, TFunction<void()>&& Task)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	UWallRunTaskScheduler* Scheduler = World != nullptr ? World->GetSubsystem<UWallRunTaskScheduler>() : nullptr;
+
+	if (Scheduler != nullptr)
+	{
+		Scheduler->AddTask(Priority, MoveTemp(Task));
+	}
+	else
+	{
+		Task();
+	}
+}
+
+int32 UWallRunTaskScheduler::GetNumPendingTasks() const
+{
+	int32 NumPending = 0;
+	for (const TArray<FTask>& Queue : Queues)
+	{
+		NumPending += Queue.Num();
+	}
+	return NumPending;
+}
+
+void UWallRunTaskScheduler::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double BudgetSeconds = FrameBudgetMs * 0.001;
+	bool bOutOfBudget = false;
+
+	for (int32 PriorityIndex = (int32)EWallRunTaskPriority::Num - 1; PriorityIndex >= 0; --PriorityIndex)
+	{
+		TArray<FTask>& Queue = Queues[PriorityIndex];
+
+		// tasks added while running wait for the next frame
+		const int32 NumQueued = Queue.Num();
+		int32 NumDone = 0;
+		for (; NumDone < NumQueued; ++NumDone)
+		{
+			FTask& Task = Queue[NumDone];
+			const bool bMustRun = GFrameCounter - Task.EnqueueFrame >= (uint64)MaxDeferredFrames;
+
+			if (bOutOfBudget && !bMustRun)
+			{
+				break;
+			}
+
+			TFunction<void()> Function = MoveTemp(Task.Function);
+			Function();
+
+			++Stats.TasksRun;
+			if (bOutOfBudget)
+			{
+				++Stats.TasksForced;
+			}
+
+			bOutOfBudget = bOutOfBudget || FPlatformTime::Seconds() - StartTime >= BudgetSeconds;
+		}
+
+		// whatever is left is waiting for one more frame
+		for (int32 Index = NumDone; Index < NumQueued; ++Index)
+		{
+			if (Queue[Index].EnqueueFrame == GFrameCounter)
+			{
+				++Stats.TasksDeferred;
+			}
+		}
+
+		Queue.RemoveAt(0, NumDone, false);
+	}
+
+	Stats.LastFrameMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	if (Stats.LastFrameMs > FrameBudgetMs)
+	{
+		++Stats.OverrunFrames;
+		Stats.MaxOverrunMs = FMath::Max(Stats.MaxOverrunMs, Stats.LastFrameMs - FrameBudgetMs);
+	}
+}
+
+TStatId UWallRunTaskScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWallRunTaskScheduler, STATGROUP_Tickables);
+}
+
+void UWallRunTaskScheduler::Deinitialize()
+{
+	for (TArray<FTask>& Queue : Queues)
+	{
+		Queue.Empty();
+	}
+
+	Super::Deinitialize();
+}
+
+namespace
+{
+	void PrintSchedulerStats(UWorld* World)
+	{
+		const UWallRunTaskScheduler* Scheduler = World != nullptr ? World->GetSubsystem<UWallRunTaskScheduler>() : nullptr;
+		if (Scheduler == nullptr)
+		{
+			return;
+		}
+
+		const FWallRunTaskSchedulerStats& Stats = Scheduler->GetStats();
+		UE_LOG(LogWallRunScheduler, Display, TEXT("Tasks run: %llu, deferred: %llu, forced: %llu, pending: %d"),
+			Stats.TasksRun, Stats.TasksDeferred, Stats.TasksForced, Scheduler->GetNumPendingTasks());
+		UE_LOG(LogWallRunScheduler, Display, TEXT("Overrun frames: %llu, max overrun: %.3f ms, last frame: %.3f ms"),
+			Stats.OverrunFrames, Stats.MaxOverrunMs, Stats.LastFrameMs);
+	}
+
+	FAutoConsoleCommandWithWorld WallRunSchedulerStatsCommand(
+		TEXT("WallRun.Scheduler.Stats"),
+		TEXT("Print budget scheduler stats for the current world"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&PrintSchedulerStats));
+}
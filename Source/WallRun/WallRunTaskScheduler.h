@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WallRunTaskScheduler.generated.h"
+
+// order of execution inside a frame, higher runs first
+enum class EWallRunTaskPriority : uint8
+{
+	Low = 0,
+	Normal,
+	High,
+	Num
+};
+
+struct FWallRunTaskSchedulerStats
+{
+	// tasks executed since world start
+	uint64 TasksRun = 0;
+	// tasks that had to wait at least one frame
+	uint64 TasksDeferred = 0;
+	// tasks run over budget because they waited MaxDeferredFrames
+	uint64 TasksForced = 0;
+	// frames where executed work went over the budget
+	uint64 OverrunFrames = 0;
+	double MaxOverrunMs = 0.0;
+	double LastFrameMs = 0.0;
+};
+
+/**
+ * Runs deferrable gameplay work (cosmetics, despawn) within a per-frame time budget,
+ * so many events landing on the same frame don't make a spike.
+ */
+UCLASS(config = Game)
+class UWallRunTaskScheduler : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// queue task, it runs this frame or later depending on the budget
+	void AddTask(EWallRunTaskPriority Priority, TFunction<void()>&& Task);
+
+	// run task through world scheduler, or right now if there is none
+	static void AddTask(const UObject* WorldContextObject, EWallRunTaskPriority Priority, TFunction<void()>&& Task);
+
+	const FWallRunTaskSchedulerStats& GetStats() const { return Stats; }
+	int32 GetNumPendingTasks() const;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+protected:
+	// time for deferred tasks in one frame
+	UPROPERTY(config)
+	float FrameBudgetMs = 1.0f;
+
+	// tasks waiting longer than this run regardless of the budget
+	UPROPERTY(config)
+	int32 MaxDeferredFrames = 30;
+
+private:
+	struct FTask
+	{
+		TFunction<void()> Function;
+		uint64 EnqueueFrame = 0;
+	};
+
+	TArray<FTask> Queues[(int32)EWallRunTaskPriority::Num];
+	FWallRunTaskSchedulerStats Stats;
+};
@@ -0,0 +1,256 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WallRunTelemetry.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunTelemetry, Log, All);
+
+static TAutoConsoleVariable<int32> CVarTelemetryEnabled(
+	TEXT("WallRun.Telemetry"),
+	1,
+	TEXT("Record gameplay telemetry to Saved/Telemetry"));
+
+static TAutoConsoleVariable<int32> CVarTelemetryMaxFileSizeKB(
+	TEXT("WallRun.Telemetry.MaxFileSizeKB"),
+	4096,
+	TEXT("Start a new telemetry file after this size"));
+
+static TAutoConsoleVariable<int32> CVarTelemetryMaxFiles(
+	TEXT("WallRun.Telemetry.MaxFiles"),
+	16,
+	TEXT("Number of telemetry files kept on disk over all sessions, older ones are deleted"));
+
+// how often the writer thread drains the rings
+static constexpr float TelemetryFlushInterval = 0.1f;
+
+FWallRunTelemetry& FWallRunTelemetry::Get()
+{
+	static FWallRunTelemetry Instance;
+	return Instance;
+}
+
+FWallRunTelemetry::~FWallRunTelemetry()
+{
+	Shutdown();
+}
+
+void FWallRunTelemetry::Record(EWallRunTelemetryEvent Event, const AActor* Actor, float Value, EWallRunStopReason Reason)
+{
+	if (CVarTelemetryEnabled.GetValueOnAnyThread() == 0)
+	{
+		return;
+	}
+
+	FWallRunTelemetry& Telemetry = Get();
+	if (Telemetry.bShutdown.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	if (!Telemetry.bStarted.load(std::memory_order_acquire))
+	{
+		Telemetry.StartThread();
+	}
+
+	FWallRunTelemetryRecord Record;
+	Record.Time = FPlatformTime::Seconds() - Telemetry.StartTime;
+	Record.Event = Event;
+	Record.Reason = Reason;
+	Record.Value = Value;
+
+	if (Actor != nullptr)
+	{
+		const FVector Location = Actor->GetActorLocation();
+		Record.ObjectId = Actor->GetUniqueID();
+		Record.Location[0] = (float)Location.X;
+		Record.Location[1] = (float)Location.Y;
+		Record.Location[2] = (float)Location.Z;
+	}
+
+	Telemetry.Push(Record);
+}
+
+FWallRunTelemetry::FThreadRing* FWallRunTelemetry::GetThreadRing()
+{
+	static thread_local FThreadRing* ThreadRing = nullptr;
+
+	if (ThreadRing == nullptr)
+	{
+		// once per thread, rings live until shutdown
+		ThreadRing = new FThreadRing();
+
+		FScopeLock Lock(&RingsLock);
+		Rings.Add(ThreadRing);
+	}
+
+	return ThreadRing;
+}
+
+void FWallRunTelemetry::Push(const FWallRunTelemetryRecord& Record)
+{
+	FThreadRing* Ring = GetThreadRing();
+
+	const uint32 Tail = Ring->Tail.load(std::memory_order_relaxed);
+	const uint32 Head = Ring->Head.load(std::memory_order_acquire);
+	if (Tail - Head >= FThreadRing::Capacity)
+	{
+		NumDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	Ring->Records[Tail % FThreadRing::Capacity] = Record;
+	Ring->Tail.store(Tail + 1, std::memory_order_release);
+}
+
+void FWallRunTelemetry::StartThread()
+{
+	FScopeLock Lock(&StartLock);
+
+	if (Thread != nullptr || bShutdown)
+	{
+		return;
+	}
+
+	StartTime = FPlatformTime::Seconds();
+	SessionName = FDateTime::Now().ToString(TEXT("%Y.%m.%d-%H.%M.%S"));
+	Thread = FRunnableThread::Create(this, TEXT("WallRunTelemetry"), 0, TPri_BelowNormal);
+	bStarted.store(true, std::memory_order_release);
+}
+
+uint32 FWallRunTelemetry::Run()
+{
+	while (!bStopping.load())
+	{
+		Drain();
+		FPlatformProcess::Sleep(TelemetryFlushInterval);
+	}
+
+	// last events recorded before shutdown
+	Drain();
+	CloseFile();
+
+	return 0;
+}
+
+void FWallRunTelemetry::Stop()
+{
+	bStopping.store(true);
+}
+
+void FWallRunTelemetry::Shutdown()
+{
+	{
+		FScopeLock Lock(&StartLock);
+		if (bShutdown.load())
+		{
+			return;
+		}
+		bShutdown.store(true);
+	}
+
+	if (Thread != nullptr)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	if (NumDropped.load() > 0)
+	{
+		UE_LOG(LogWallRunTelemetry, Warning, TEXT("%llu telemetry events were dropped, ring was full"), NumDropped.load());
+	}
+
+	FScopeLock Lock(&RingsLock);
+	for (FThreadRing* Ring : Rings)
+	{
+		delete Ring;
+	}
+	Rings.Empty();
+}
+
+void FWallRunTelemetry::Drain()
+{
+	WriteBuffer.Reset();
+
+	{
+		FScopeLock Lock(&RingsLock);
+		for (FThreadRing* Ring : Rings)
+		{
+			const uint32 Head = Ring->Head.load(std::memory_order_relaxed);
+			const uint32 Tail = Ring->Tail.load(std::memory_order_acquire);
+			for (uint32 Index = Head; Index != Tail; ++Index)
+			{
+				WriteBuffer.Add(Ring->Records[Index % FThreadRing::Capacity]);
+			}
+			Ring->Head.store(Tail, std::memory_order_release);
+		}
+	}
+
+	if (WriteBuffer.Num() == 0)
+	{
+		return;
+	}
+
+	// events from different threads end up in time order
+	WriteBuffer.Sort([](const FWallRunTelemetryRecord& A, const FWallRunTelemetryRecord& B) { return A.Time < B.Time; });
+
+	if (File == nullptr || FileSize >= CVarTelemetryMaxFileSizeKB.GetValueOnAnyThread() * 1024LL)
+	{
+		OpenNextFile();
+	}
+
+	if (File != nullptr)
+	{
+		const int64 NumBytes = WriteBuffer.Num() * sizeof(FWallRunTelemetryRecord);
+		File->Write(reinterpret_cast<const uint8*>(WriteBuffer.GetData()), NumBytes);
+		File->Flush();
+		FileSize += NumBytes;
+	}
+}
+
+void FWallRunTelemetry::OpenNextFile()
+{
+	CloseFile();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString Directory = FPaths::ProjectSavedDir() / TEXT("Telemetry");
+	PlatformFile.CreateDirectoryTree(*Directory);
+
+	// keep only last MaxFiles files, names start with session time and file index so they sort by age
+	const int32 MaxFiles = FMath::Max(1, CVarTelemetryMaxFiles.GetValueOnAnyThread());
+	TArray<FString> ExistingFiles;
+	IFileManager::Get().FindFiles(ExistingFiles, *(Directory / TEXT("WallRun_*.wrt")), true, false);
+	ExistingFiles.Sort();
+	for (int32 Index = 0; Index <= ExistingFiles.Num() - MaxFiles; ++Index)
+	{
+		PlatformFile.DeleteFile(*(Directory / ExistingFiles[Index]));
+	}
+
+	const FString FilePath = Directory / FString::Printf(TEXT("WallRun_%s_%03d.wrt"), *SessionName, FileIndex);
+	++FileIndex;
+
+	File = PlatformFile.OpenWrite(*FilePath);
+	if (File == nullptr)
+	{
+		UE_LOG(LogWallRunTelemetry, Warning, TEXT("Can't open telemetry file %s"), *FilePath);
+		return;
+	}
+
+	const FWallRunTelemetryFileHeader Header;
+	File->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	FileSize = sizeof(Header);
+}
+
+void FWallRunTelemetry::CloseFile()
+{
+	delete File;
+	File = nullptr;
+	FileSize = 0;
+}
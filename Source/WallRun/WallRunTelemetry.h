@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include <atomic>
+
+class FRunnableThread;
+class IFileHandle;
+
+enum class EWallRunTelemetryEvent : uint8
+{
+	WallRunStart = 0,
+	WallRunStop,
+	Death,
+	Checkpoint,
+	Shot,
+	BoostStart,
+	BoostEnd
+};
+
+// why the wall run ended
+enum class EWallRunStopReason : uint8
+{
+	None = 0,
+	Timeout,
+	KeyRelease,
+	SideChange,
+	LostWall,
+	Jump,
+	Restore
+};
+
+/** One event on disk, fixed size so files can be read without parsing */
+struct FWallRunTelemetryRecord
+{
+	// seconds since telemetry start
+	double Time = 0.0;
+	uint32 ObjectId = 0;
+	EWallRunTelemetryEvent Event = EWallRunTelemetryEvent::WallRunStart;
+	EWallRunStopReason Reason = EWallRunStopReason::None;
+	uint16 Padding = 0;
+	// event specific value: duration for stops, game time for checkpoints
+	float Value = 0.0f;
+	float Location[3] = { 0.0f, 0.0f, 0.0f };
+};
+static_assert(sizeof(FWallRunTelemetryRecord) == 32, "Telemetry record size is part of the file format");
+
+/** Header at the start of every telemetry file */
+struct FWallRunTelemetryFileHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x4C545257; // "WRTL"
+	static constexpr uint32 CurrentVersion = 1;
+
+	uint32 Magic = ExpectedMagic;
+	uint32 Version = CurrentVersion;
+	uint32 RecordSize = sizeof(FWallRunTelemetryRecord);
+	uint32 Padding = 0;
+};
+
+/**
+ * Gameplay telemetry written to Saved/Telemetry.
+ * Record() only copies into a lock-free ring of the calling thread,
+ * a background thread drains the rings into rotating files.
+ */
+class FWallRunTelemetry : public FRunnable
+{
+public:
+	static FWallRunTelemetry& Get();
+
+	// cheap, can be called from any thread, drops the event if the ring is full
+	static void Record(EWallRunTelemetryEvent Event, const AActor* Actor, float Value = 0.0f, EWallRunStopReason Reason = EWallRunStopReason::None);
+
+	// flush everything and stop the writer thread
+	void Shutdown();
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	FWallRunTelemetry() = default;
+	virtual ~FWallRunTelemetry();
+
+	// single producer, single consumer
+	struct FThreadRing
+	{
+		static constexpr uint32 Capacity = 4096;
+
+		FWallRunTelemetryRecord Records[Capacity];
+		std::atomic<uint32> Head{ 0 };
+		std::atomic<uint32> Tail{ 0 };
+	};
+
+	FThreadRing* GetThreadRing();
+	void Push(const FWallRunTelemetryRecord& Record);
+	void StartThread();
+	void Drain();
+	void OpenNextFile();
+	void CloseFile();
+
+	FCriticalSection RingsLock;
+	TArray<FThreadRing*> Rings;
+
+	FCriticalSection StartLock;
+	FRunnableThread* Thread = nullptr;
+	std::atomic<bool> bStarted{ false };
+	std::atomic<bool> bStopping{ false };
+	std::atomic<bool> bShutdown{ false };
+
+	// writer thread only
+	IFileHandle* File = nullptr;
+	int64 FileSize = 0;
+	int32 FileIndex = 0;
+	FString SessionName;
+	TArray<FWallRunTelemetryRecord> WriteBuffer;
+
+	double StartTime = 0.0;
+	std::atomic<uint64> NumDropped{ 0 };
+};
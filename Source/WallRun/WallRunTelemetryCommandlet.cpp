@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WallRunTelemetryCommandlet.h"
+#include "WallRunTelemetry.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunTelemetryCsv, Log, All);
+
+namespace
+{
+	const TCHAR* GetEventName(EWallRunTelemetryEvent Event)
+	{
+		switch (Event)
+		{
+		case EWallRunTelemetryEvent::WallRunStart: return TEXT("WallRunStart");
+		case EWallRunTelemetryEvent::WallRunStop: return TEXT("WallRunStop");
+		case EWallRunTelemetryEvent::Death: return TEXT("Death");
+		case EWallRunTelemetryEvent::Checkpoint: return TEXT("Checkpoint");
+		case EWallRunTelemetryEvent::Shot: return TEXT("Shot");
+		case EWallRunTelemetryEvent::BoostStart: return TEXT("BoostStart");
+		case EWallRunTelemetryEvent::BoostEnd: return TEXT("BoostEnd");
+		default: return TEXT("Unknown");
+		}
+	}
+
+	const TCHAR* GetReasonName(EWallRunStopReason Reason)
+	{
+		switch (Reason)
+		{
+		case EWallRunStopReason::None: return TEXT("");
+		case EWallRunStopReason::Timeout: return TEXT("Timeout");
+		case EWallRunStopReason::KeyRelease: return TEXT("KeyRelease");
+		case EWallRunStopReason::SideChange: return TEXT("SideChange");
+		case EWallRunStopReason::LostWall: return TEXT("LostWall");
+		case EWallRunStopReason::Jump: return TEXT("Jump");
+		case EWallRunStopReason::Restore: return TEXT("Restore");
+		default: return TEXT("Unknown");
+		}
+	}
+
+	bool AppendFileToCsv(const FString& FilePath, FString& Csv)
+	{
+		TArray<uint8> Data;
+		if (!FFileHelper::LoadFileToArray(Data, *FilePath))
+		{
+			UE_LOG(LogWallRunTelemetryCsv, Error, TEXT("Can't read %s"), *FilePath);
+			return false;
+		}
+
+		FWallRunTelemetryFileHeader Header;
+		if (Data.Num() < (int32)sizeof(Header))
+		{
+			UE_LOG(LogWallRunTelemetryCsv, Error, TEXT("%s is too small for a telemetry file"), *FilePath);
+			return false;
+		}
+
+		FMemory::Memcpy(&Header, Data.GetData(), sizeof(Header));
+		if (Header.Magic != FWallRunTelemetryFileHeader::ExpectedMagic
+			|| Header.Version != FWallRunTelemetryFileHeader::CurrentVersion
+			|| Header.RecordSize != sizeof(FWallRunTelemetryRecord))
+		{
+			UE_LOG(LogWallRunTelemetryCsv, Error, TEXT("%s is not a supported telemetry file"), *FilePath);
+			return false;
+		}
+
+		const FString FileName = FPaths::GetCleanFilename(FilePath);
+		const int32 NumRecords = (Data.Num() - (int32)sizeof(Header)) / (int32)sizeof(FWallRunTelemetryRecord);
+		for (int32 Index = 0; Index < NumRecords; ++Index)
+		{
+			FWallRunTelemetryRecord Record;
+			FMemory::Memcpy(&Record, Data.GetData() + sizeof(Header) + Index * sizeof(FWallRunTelemetryRecord), sizeof(Record));
+
+			Csv += FString::Printf(TEXT("%s,%.6f,%u,%s,%s,%.4f,%.2f,%.2f,%.2f\n"),
+				*FileName, Record.Time, Record.ObjectId, GetEventName(Record.Event), GetReasonName(Record.Reason),
+				Record.Value, Record.Location[0], Record.Location[1], Record.Location[2]);
+		}
+
+		return true;
+	}
+}
+
+int32 UWallRunTelemetryToCsvCommandlet::Main(const FString& Params)
+{
+	const FString TelemetryDir = FPaths::ProjectSavedDir() / TEXT("Telemetry");
+
+	FString InPath = TelemetryDir;
+	FString OutPath = TelemetryDir / TEXT("Telemetry.csv");
+	FParse::Value(*Params, TEXT("In="), InPath);
+	FParse::Value(*Params, TEXT("Out="), OutPath);
+
+	TArray<FString> Files;
+	if (IFileManager::Get().DirectoryExists(*InPath))
+	{
+		IFileManager::Get().FindFiles(Files, *(InPath / TEXT("*.wrt")), true, false);
+		for (FString& File : Files)
+		{
+			File = InPath / File;
+		}
+		// file names start with the session time, so this is chronological
+		Files.Sort();
+	}
+	else
+	{
+		Files.Add(InPath);
+	}
+
+	FString Csv = TEXT("File,Time,ObjectId,Event,Reason,Value,X,Y,Z\n");
+	int32 NumFailed = 0;
+	for (const FString& File : Files)
+	{
+		NumFailed += AppendFileToCsv(File, Csv) ? 0 : 1;
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *OutPath))
+	{
+		UE_LOG(LogWallRunTelemetryCsv, Error, TEXT("Can't write %s"), *OutPath);
+		return 1;
+	}
+
+	UE_LOG(LogWallRunTelemetryCsv, Display, TEXT("Converted %d telemetry files to %s"), Files.Num() - NumFailed, *OutPath);
+	return NumFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "WallRunTelemetryCommandlet.generated.h"
+
+/**
+ * Converts telemetry files to CSV.
+ * Usage: -run=WallRunTelemetryToCsv [In=<file or directory>] [Out=<csv file>]
+ * By default reads every file in Saved/Telemetry and writes Saved/Telemetry/Telemetry.csv
+ */
+UCLASS()
+class UWallRunTelemetryToCsvCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,248 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WallRunTimingWheel.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunTimingWheel, Log, All);
+
+UWallRunTimingWheel* UWallRunTimingWheel::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World != nullptr ? World->GetSubsystem<UWallRunTimingWheel>() : nullptr;
+}
+
+void UWallRunTimingWheel::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TickInterval = FMath::Max(TickInterval, 0.001f);
+
+	const uint32 SlotCount = FMath::RoundUpToPowerOfTwo((uint32)FMath::Max(NumSlots, 1));
+	Slots.Init(INDEX_NONE, SlotCount);
+	SlotMask = SlotCount - 1;
+}
+
+void UWallRunTimingWheel::Deinitialize()
+{
+	Timers.Empty();
+	Slots.Empty();
+	FreeHead = INDEX_NONE;
+	Stats.NumActive = 0;
+
+	Super::Deinitialize();
+}
+
+void UWallRunTimingWheel::SetTimer(FWallRunTimerHandle& Handle, UObject* Owner, FWallRunTimerCallback Callback, float Delay)
+{
+	ClearTimer(Handle);
+
+	// like FTimerManager, no delay means no timer
+	if (Owner == nullptr || Callback == nullptr || Delay <= 0.0f || Slots.Num() == 0)
+	{
+		return;
+	}
+
+	int32 Index = FreeHead;
+	if (Index != INDEX_NONE)
+	{
+		FreeHead = Timers[Index].Next;
+	}
+	else
+	{
+		Index = Timers.AddDefaulted();
+	}
+
+	FTimer& Timer = Timers[Index];
+	Timer.ExpireTick = CurrentTick + (uint64)FMath::Max(1, FMath::CeilToInt((Accumulated + Delay) / TickInterval));
+	Timer.Owner = Owner;
+	Timer.Callback = Callback;
+	Timer.bActive = true;
+	++Timer.Serial;
+	LinkToSlot(Index);
+
+	Handle.Index = Index;
+	Handle.Serial = Timer.Serial;
+
+	++Stats.NumActive;
+	Stats.MaxActive = FMath::Max(Stats.MaxActive, Stats.NumActive);
+}
+
+void UWallRunTimingWheel::ClearTimer(FWallRunTimerHandle& Handle)
+{
+	if (FindTimer(Handle) != nullptr)
+	{
+		Unlink(Handle.Index);
+		Release(Handle.Index);
+	}
+
+	Handle.Invalidate();
+}
+
+bool UWallRunTimingWheel::IsTimerActive(FWallRunTimerHandle Handle) const
+{
+	return FindTimer(Handle) != nullptr;
+}
+
+float UWallRunTimingWheel::GetTimerRemaining(FWallRunTimerHandle Handle) const
+{
+	const FTimer* Timer = FindTimer(Handle);
+	if (Timer == nullptr)
+	{
+		return -1.0f;
+	}
+
+	return (Timer->ExpireTick - CurrentTick) * TickInterval - Accumulated;
+}
+
+const UWallRunTimingWheel::FTimer* UWallRunTimingWheel::FindTimer(FWallRunTimerHandle Handle) const
+{
+	if (!Handle.IsValid() || !Timers.IsValidIndex(Handle.Index))
+	{
+		return nullptr;
+	}
+
+	const FTimer& Timer = Timers[Handle.Index];
+	return Timer.bActive && Timer.Serial == Handle.Serial ? &Timer : nullptr;
+}
+
+void UWallRunTimingWheel::LinkToSlot(int32 Index)
+{
+	FTimer& Timer = Timers[Index];
+	int32& SlotHead = Slots[(int32)(Timer.ExpireTick & SlotMask)];
+
+	Timer.Prev = INDEX_NONE;
+	Timer.Next = SlotHead;
+	if (SlotHead != INDEX_NONE)
+	{
+		Timers[SlotHead].Prev = Index;
+	}
+	SlotHead = Index;
+}
+
+void UWallRunTimingWheel::Unlink(int32 Index)
+{
+	const FTimer& Timer = Timers[Index];
+
+	if (Timer.Prev != INDEX_NONE)
+	{
+		Timers[Timer.Prev].Next = Timer.Next;
+	}
+	else
+	{
+		Slots[(int32)(Timer.ExpireTick & SlotMask)] = Timer.Next;
+	}
+
+	if (Timer.Next != INDEX_NONE)
+	{
+		Timers[Timer.Next].Prev = Timer.Prev;
+	}
+}
+
+void UWallRunTimingWheel::Release(int32 Index)
+{
+	FTimer& Timer = Timers[Index];
+	Timer.bActive = false;
+	Timer.Owner.Reset();
+	Timer.Callback = nullptr;
+	Timer.Prev = INDEX_NONE;
+	Timer.Next = FreeHead;
+	FreeHead = Index;
+
+	--Stats.NumActive;
+}
+
+void UWallRunTimingWheel::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	Accumulated += DeltaTime;
+	while (Accumulated >= TickInterval)
+	{
+		Accumulated -= TickInterval;
+		++CurrentTick;
+		ExpireSlot(CurrentTick);
+	}
+}
+
+void UWallRunTimingWheel::ExpireSlot(uint64 Tick)
+{
+	// collect first, callbacks may set and clear timers
+	Expired.Reset();
+	for (int32 Index = Slots[(int32)(Tick & SlotMask)]; Index != INDEX_NONE;)
+	{
+		const FTimer& Timer = Timers[Index];
+		const int32 Next = Timer.Next;
+
+		// timers with more turns to go stay in the slot
+		if (Timer.ExpireTick <= Tick)
+		{
+			if (UObject* Owner = Timer.Owner.Get())
+			{
+				Expired.Emplace(Timer.Callback, Owner);
+			}
+			Unlink(Index);
+			Release(Index);
+			++Stats.NumExpired;
+		}
+
+		Index = Next;
+	}
+
+	if (Expired.Num() == 0)
+	{
+		return;
+	}
+
+	// one call per callback with all of its owners
+	Expired.StableSort([](const TPair<FWallRunTimerCallback, UObject*>& A, const TPair<FWallRunTimerCallback, UObject*>& B)
+	{
+		return (UPTRINT)A.Key < (UPTRINT)B.Key;
+	});
+
+	for (int32 Start = 0; Start < Expired.Num();)
+	{
+		const FWallRunTimerCallback Callback = Expired[Start].Key;
+
+		Batch.Reset();
+		int32 End = Start;
+		for (; End < Expired.Num() && Expired[End].Key == Callback; ++End)
+		{
+			Batch.Add(Expired[End].Value);
+		}
+
+		Callback(Batch);
+
+		++Stats.NumCallbacks;
+		Stats.MaxBatch = FMath::Max(Stats.MaxBatch, Batch.Num());
+		Start = End;
+	}
+}
+
+TStatId UWallRunTimingWheel::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWallRunTimingWheel, STATGROUP_Tickables);
+}
+
+namespace
+{
+	void PrintTimingWheelStats(UWorld* World)
+	{
+		const UWallRunTimingWheel* TimingWheel = World != nullptr ? World->GetSubsystem<UWallRunTimingWheel>() : nullptr;
+		if (TimingWheel == nullptr)
+		{
+			return;
+		}
+
+		const FWallRunTimingWheelStats& Stats = TimingWheel->GetStats();
+		UE_LOG(LogWallRunTimingWheel, Display, TEXT("Active timers: %d, max active: %d"), Stats.NumActive, Stats.MaxActive);
+		UE_LOG(LogWallRunTimingWheel, Display, TEXT("Expired: %llu, callbacks: %llu, max batch: %d"), Stats.NumExpired, Stats.NumCallbacks, Stats.MaxBatch);
+	}
+
+	FAutoConsoleCommandWithWorld WallRunTimingWheelStatsCommand(
+		TEXT("WallRun.TimingWheel.Stats"),
+		TEXT("Print timing wheel stats for the current world"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&PrintTimingWheelStats));
+}
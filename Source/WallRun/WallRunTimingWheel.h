@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WallRunTimingWheel.generated.h"
+
+// called once per tick with every owner whose timer with this callback expired
+using FWallRunTimerCallback = void (*)(TArrayView<UObject* const> Owners);
+
+/** Compact handle of a timing wheel timer, stale handles are detected by serial */
+struct FWallRunTimerHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Serial = 0;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+	void Invalidate() { Index = INDEX_NONE; }
+};
+
+struct FWallRunTimingWheelStats
+{
+	int32 NumActive = 0;
+	int32 MaxActive = 0;
+	uint64 NumExpired = 0;
+	uint64 NumCallbacks = 0;
+	int32 MaxBatch = 0;
+};
+
+/**
+ * Hashed timing wheel for gameplay cooldowns and durations.
+ * Set, clear and remaining time are O(1), timers live in one pooled array.
+ * Expired timers with the same callback are delivered in one call, so many
+ * characters ending a wall run on the same tick cost one callback.
+ */
+UCLASS(config = Game)
+class UWallRunTimingWheel : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UWallRunTimingWheel* Get(const UObject* WorldContextObject);
+
+	// Delay is rounded up to the wheel resolution, clears the timer Handle pointed to before
+	void SetTimer(FWallRunTimerHandle& Handle, UObject* Owner, FWallRunTimerCallback Callback, float Delay);
+	void ClearTimer(FWallRunTimerHandle& Handle);
+	bool IsTimerActive(FWallRunTimerHandle Handle) const;
+	// seconds until expiry, -1 when the timer is not active, same as FTimerManager
+	float GetTimerRemaining(FWallRunTimerHandle Handle) const;
+
+	const FWallRunTimingWheelStats& GetStats() const { return Stats; }
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	// wheel resolution in seconds
+	UPROPERTY(config)
+	float TickInterval = 1.0f / 120.0f;
+
+	// rounded up to a power of two, timers further than NumSlots ticks wait for more turns
+	UPROPERTY(config)
+	int32 NumSlots = 512;
+
+private:
+	struct FTimer
+	{
+		uint64 ExpireTick = 0;
+		TWeakObjectPtr<UObject> Owner;
+		FWallRunTimerCallback Callback = nullptr;
+		uint32 Serial = 0;
+		// slot list links, or free list link in Next
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+		bool bActive = false;
+	};
+
+	const FTimer* FindTimer(FWallRunTimerHandle Handle) const;
+	void LinkToSlot(int32 Index);
+	void Unlink(int32 Index);
+	void Release(int32 Index);
+	void ExpireSlot(uint64 Tick);
+
+	TArray<FTimer> Timers;
+	// head of each slot list
+	TArray<int32> Slots;
+	int32 FreeHead = INDEX_NONE;
+	uint64 SlotMask = 0;
+
+	uint64 CurrentTick = 0;
+	float Accumulated = 0.0f;
+
+	// reused between ticks
+	TArray<TPair<FWallRunTimerCallback, UObject*>> Expired;
+	TArray<UObject*> Batch;
+
+	FWallRunTimingWheelStats Stats;
+};